@@ -1,7 +1,14 @@
-#include "src/typer.h"
-
-int main()
-{
-    Typer app;
-    app.run();
-}
\ No newline at end of file
+#include "src/typer.h"
+
+int main(int argc, char *argv[])
+{
+    const std::string command = argc > 1 ? argv[1] : "";
+    if (command == "--server" && argc <= 3)
+        return RaceServer::run(argc == 3 ? argv[2] : RACE_SOCKET_PATH);
+    if (argc > 1 && !(command == "--race" && argc <= 3))
+        return Replayer::run(argc, argv);
+    Typer app;
+    if (command == "--race" && !app.join_race(argc == 3 ? argv[2] : RACE_SOCKET_PATH))
+        return EXIT_FAILURE;
+    app.run();
+}
@@ -4,22 +4,48 @@ SRC_PATH=src
 GENERATOR=generator
 TYPER=typer
 LOGGER=logger
+CORPUS=corpus
+TTW=ttw
+TERMINAL=terminal
+RENDERER=renderer
+SETTINGS=settings
+KEYSTROKES=keystrokes
+RESULTS_STORE=results_store
+STATS=stats
+ADAPTIVE=adaptive
+TEXT_STREAM=text_stream
+UTF8=utf8
+INPUT=input
+TEST_ENGINE=test_engine
+REPLAY=replay
+RACE=race
+TIMELINE=timeline
+TOOLS_PATH=tools
+COMPILE_WORDS=compile_words
+BENCHMARK=benchmark
+DECODE_LOG=decode_log
 DELETE_AFTER=1
 DELETE_LOGS=1
 DELETE_RESULT=1
+COMPILE_LISTS=1
+RUN_BENCHMARK=1
+DECODE_LOG_FILE=
 
 function usage() {
     echo "$0 [OPTION]"
     echo '-e, --erase-binary     delete binary file after'
     echo '-l                     delete source log files'
-    echo '-r                     delete results log file'
+    echo '-r                     delete results file'
     echo '--erase-log            combined -l and -r'
     echo '--all                  delete binary and log files (-elr)'
+    echo '-c, --compile-words    compile words/*.txt into .ttw lists before running'
+    echo '-b, --benchmark        build and run the benchmark (writes benchmark.json) instead of the app'
+    echo '-d, --decode-log FILE  build the log decoder and print binary log FILE as text instead of running the app'
     echo '-h                     show this message'
 }
 
 # handle arguments
-while getopts ":elrh-:" opt; do
+while getopts ":elrcbd:h-:" opt; do
     case $opt in
     e)
         echo 'Delete binary after finish flag is set'
@@ -30,9 +56,20 @@ while getopts ":elrh-:" opt; do
         DELETE_LOGS=0
         ;;
     r)
-        echo 'Delete results log file flag is set'
+        echo 'Delete results file flag is set'
         DELETE_RESULT=0
         ;;
+    c)
+        echo 'Compile word lists flag is set'
+        COMPILE_LISTS=0
+        ;;
+    b)
+        echo 'Benchmark flag is set'
+        RUN_BENCHMARK=0
+        ;;
+    d)
+        DECODE_LOG_FILE=$OPTARG
+        ;;
     h)
         usage
         exit 0
@@ -48,6 +85,22 @@ while getopts ":elrh-:" opt; do
             echo 'Delete after finish flag is set d'
             DELETE_AFTER=0
             ;;
+        compile-words)
+            echo 'Compile word lists flag is set'
+            COMPILE_LISTS=0
+            ;;
+        benchmark)
+            echo 'Benchmark flag is set'
+            RUN_BENCHMARK=0
+            ;;
+        decode-log)
+            if [ $OPTIND -gt $# ]; then
+                echo "Option --${OPTARG} requires an argument." >&2
+                exit 1
+            fi
+            DECODE_LOG_FILE=${!OPTIND}
+            OPTIND=$((OPTIND + 1))
+            ;;
         all)
             echo 'Delete binary and log files after finish flag is set'
             DELETE_AFTER=0
@@ -77,7 +130,7 @@ shift $((OPTIND - 1))
 # Cleanup
 function do_clean() {
     echo 'Cleaning up..'
-    rm -rf $SRC_PATH/*.obj *.obj 2>/dev/null
+    rm -rf $SRC_PATH/*.obj $TOOLS_PATH/*.obj *.obj 2>/dev/null
 }
 
 # Check if files exist
@@ -87,7 +140,7 @@ function check() {
         exit 1
     fi
 
-    if !([ -f "$SRC_PATH/$GENERATOR.cpp" ]) || !([ -f "$SRC_PATH/$TYPER.cpp" ]) || !([ -f "$SRC_PATH/$LOGGER.cpp" ]); then
+    if !([ -f "$SRC_PATH/$GENERATOR.cpp" ]) || !([ -f "$SRC_PATH/$TYPER.cpp" ]) || !([ -f "$SRC_PATH/$LOGGER.cpp" ]) || !([ -f "$SRC_PATH/$CORPUS.cpp" ]) || !([ -f "$SRC_PATH/$TTW.cpp" ]) || !([ -f "$SRC_PATH/$TERMINAL.cpp" ]) || !([ -f "$SRC_PATH/$RENDERER.cpp" ]) || !([ -f "$SRC_PATH/$SETTINGS.cpp" ]) || !([ -f "$SRC_PATH/$KEYSTROKES.cpp" ]) || !([ -f "$SRC_PATH/$RESULTS_STORE.cpp" ]) || !([ -f "$SRC_PATH/$STATS.cpp" ]) || !([ -f "$SRC_PATH/$ADAPTIVE.cpp" ]) || !([ -f "$SRC_PATH/$TEXT_STREAM.cpp" ]) || !([ -f "$SRC_PATH/$UTF8.cpp" ]) || !([ -f "$SRC_PATH/$INPUT.cpp" ]) || !([ -f "$SRC_PATH/$TEST_ENGINE.cpp" ]) || !([ -f "$SRC_PATH/$REPLAY.cpp" ]) || !([ -f "$SRC_PATH/$RACE.cpp" ]) || !([ -f "$SRC_PATH/$TIMELINE.cpp" ]); then
         echo 'No .cpp files'
         cleanup
         exit 1
@@ -97,10 +150,10 @@ function check() {
 # Run executable and delete if flag was given
 function run_and_delete() {
     if [ $DELETE_LOGS -eq 0 ]; then
-        find logs/ ! -name 'results.log' -type f -delete
+        find logs/ ! -name 'results.db' -type f -delete
     fi
     if [ $DELETE_RESULT -eq 0 ]; then
-        rm logs/results.log
+        rm logs/results.db
     fi
     echo 'Running main.x'
     ./main.x
@@ -111,7 +164,7 @@ function run_and_delete() {
 
 # Enumerate the files and compile them
 function compile() {
-    for cpp_file in $SRC_PATH/$GENERATOR $SRC_PATH/$TYPER $SRC_PATH/$LOGGER main; do
+    for cpp_file in $SRC_PATH/$GENERATOR $SRC_PATH/$TYPER $SRC_PATH/$LOGGER $SRC_PATH/$CORPUS $SRC_PATH/$TTW $SRC_PATH/$TERMINAL $SRC_PATH/$RENDERER $SRC_PATH/$SETTINGS $SRC_PATH/$KEYSTROKES $SRC_PATH/$RESULTS_STORE $SRC_PATH/$STATS $SRC_PATH/$ADAPTIVE $SRC_PATH/$TEXT_STREAM $SRC_PATH/$UTF8 $SRC_PATH/$INPUT $SRC_PATH/$TEST_ENGINE $SRC_PATH/$REPLAY $SRC_PATH/$RACE $SRC_PATH/$TIMELINE main; do
         echo "Compiling $cpp_file.cpp"
         g++ -std=c++17 -Wall -pedantic -c $cpp_file.cpp -o $cpp_file.obj
         if [ $? -ne 0 ]; then
@@ -120,9 +173,57 @@ function compile() {
             exit 1
         fi
     done
-    g++ $SRC_PATH/$GENERATOR.obj $SRC_PATH/$TYPER.obj $SRC_PATH/$LOGGER.obj main.obj -o main.x
+    g++ $SRC_PATH/$GENERATOR.obj $SRC_PATH/$TYPER.obj $SRC_PATH/$LOGGER.obj $SRC_PATH/$CORPUS.obj $SRC_PATH/$TTW.obj $SRC_PATH/$TERMINAL.obj $SRC_PATH/$RENDERER.obj $SRC_PATH/$SETTINGS.obj $SRC_PATH/$KEYSTROKES.obj $SRC_PATH/$RESULTS_STORE.obj $SRC_PATH/$STATS.obj $SRC_PATH/$ADAPTIVE.obj $SRC_PATH/$TEXT_STREAM.obj $SRC_PATH/$UTF8.obj $SRC_PATH/$INPUT.obj $SRC_PATH/$TEST_ENGINE.obj $SRC_PATH/$REPLAY.obj $SRC_PATH/$RACE.obj $SRC_PATH/$TIMELINE.obj main.obj -o main.x
     do_clean
 }
+
+# Build the word list compiler and compile every list from words/
+function compile_word_lists() {
+    echo "Compiling $TOOLS_PATH/$COMPILE_WORDS.cpp"
+    g++ -std=c++17 -Wall -pedantic $TOOLS_PATH/$COMPILE_WORDS.cpp $SRC_PATH/$CORPUS.cpp $SRC_PATH/$TTW.cpp -o $COMPILE_WORDS.x
+    if [ $? -ne 0 ]; then
+        echo -e "Error/warning while compiling the file: $TOOLS_PATH/$COMPILE_WORDS.cpp"
+        exit 1
+    fi
+    ./$COMPILE_WORDS.x words/*.txt
+    rm -rf $COMPILE_WORDS.x 2>/dev/null
+}
+
+# Build the benchmark with optimizations and write its results to benchmark.json
+function run_benchmark() {
+    echo "Compiling $TOOLS_PATH/$BENCHMARK.cpp"
+    g++ -std=c++17 -Wall -pedantic -O2 $TOOLS_PATH/$BENCHMARK.cpp $SRC_PATH/$GENERATOR.cpp $SRC_PATH/$TYPER.cpp $SRC_PATH/$LOGGER.cpp $SRC_PATH/$CORPUS.cpp $SRC_PATH/$TTW.cpp $SRC_PATH/$TERMINAL.cpp $SRC_PATH/$RENDERER.cpp $SRC_PATH/$SETTINGS.cpp $SRC_PATH/$KEYSTROKES.cpp $SRC_PATH/$RESULTS_STORE.cpp $SRC_PATH/$STATS.cpp $SRC_PATH/$ADAPTIVE.cpp $SRC_PATH/$TEXT_STREAM.cpp $SRC_PATH/$UTF8.cpp $SRC_PATH/$INPUT.cpp $SRC_PATH/$TEST_ENGINE.cpp $SRC_PATH/$REPLAY.cpp $SRC_PATH/$RACE.cpp $SRC_PATH/$TIMELINE.cpp -o $BENCHMARK.x
+    if [ $? -ne 0 ]; then
+        echo -e "Error/warning while compiling the file: $TOOLS_PATH/$BENCHMARK.cpp"
+        exit 1
+    fi
+    ./$BENCHMARK.x $BENCHMARK.json
+    rm -rf $BENCHMARK.x 2>/dev/null
+}
+# Build the binary log decoder and print the given log in the text format
+function decode_log() {
+    echo "Compiling $TOOLS_PATH/$DECODE_LOG.cpp" >&2
+    g++ -std=c++17 -Wall -pedantic $TOOLS_PATH/$DECODE_LOG.cpp $SRC_PATH/$LOGGER.cpp -o $DECODE_LOG.x
+    if [ $? -ne 0 ]; then
+        echo -e "Error/warning while compiling the file: $TOOLS_PATH/$DECODE_LOG.cpp" >&2
+        exit 1
+    fi
+    ./$DECODE_LOG.x "$1"
+    local status=$?
+    rm -rf $DECODE_LOG.x 2>/dev/null
+    return $status
+}
 check
+if [ -n "$DECODE_LOG_FILE" ]; then
+    decode_log "$DECODE_LOG_FILE"
+    exit $?
+fi
+if [ $COMPILE_LISTS -eq 0 ]; then
+    compile_word_lists
+fi
+if [ $RUN_BENCHMARK -eq 0 ]; then
+    run_benchmark
+    exit 0
+fi
 compile
 run_and_delete $DELETE_AFTER
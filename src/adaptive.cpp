@@ -0,0 +1,143 @@
+#include "adaptive.h"
+
+#include <algorithm>
+
+void AliasTable::build(const std::vector<float> &weights)
+{
+    const std::size_t n = weights.size();
+    this->probability.assign(n, 0.f);
+    this->alias.assign(n, 0);
+    float total = 0.f;
+    for (float weight : weights)
+        total += weight;
+    if (n == 0 || total <= 0.f)
+    {
+        this->clear();
+        return;
+    }
+
+    std::vector<float> scaled(n);
+    std::vector<uint32_t> small, large;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        scaled[i] = weights[i] * n / total;
+        (scaled[i] < 1.f ? small : large).push_back(i);
+    }
+    while (!small.empty() && !large.empty())
+    {
+        const uint32_t less = small.back(), more = large.back();
+        small.pop_back();
+        this->probability[less] = scaled[less];
+        this->alias[less] = more;
+        scaled[more] -= 1.f - scaled[less];
+        if (scaled[more] < 1.f)
+        {
+            large.pop_back();
+            small.push_back(more);
+        }
+    }
+    for (uint32_t i : large)
+        this->probability[i] = 1.f;
+    for (uint32_t i : small)
+        this->probability[i] = 1.f;
+}
+
+uint32_t AliasTable::sample(std::mt19937 &engine) const
+{
+    std::uniform_int_distribution<uint32_t> column(0, this->probability.size() - 1);
+    std::uniform_real_distribution<float> coin(0.f, 1.f);
+    const uint32_t i = column(engine);
+    return coin(engine) < this->probability[i] ? i : this->alias[i];
+}
+
+void AdaptiveSampler::index(const std::vector<std::string_view> &corpus_words)
+{
+    this->clear_index();
+    this->words = corpus_words;
+    std::vector<uint64_t> seen;
+    for (uint32_t i = 0; i < this->words.size(); ++i)
+    {
+        const std::string_view word = this->words[i];
+        const char *it = word.data(), *const end = it + word.size();
+        char32_t previous = 0, codepoint;
+        seen.clear();
+        for (std::size_t length; it < end; it += length, previous = codepoint)
+        {
+            length = decode_utf8(it, end, codepoint);
+            if (length == 0)
+                break;
+            if (previous == 0)
+                continue;
+            const uint64_t key = bigram_key(previous, codepoint);
+            if (std::find(seen.begin(), seen.end(), key) != seen.end())
+                continue;
+            seen.push_back(key);
+            this->bigram_words[key].push_back(i);
+        }
+    }
+    this->rebuild_table();
+}
+
+void AdaptiveSampler::clear_index()
+{
+    this->words.clear();
+    this->bigram_words.clear();
+    this->weighted_bigrams.clear();
+    this->table.clear();
+}
+
+void AdaptiveSampler::learn(const KeystrokeRecorder &keystrokes)
+{
+    for (auto &[key, bigram] : this->stats)
+        bigram = {bigram.attempts * ADAPTIVE_DECAY, bigram.mistakes * ADAPTIVE_DECAY, bigram.latency_ms * ADAPTIVE_DECAY};
+
+    float latency_sum = 0.f;
+    uint32_t latency_count = 0;
+    const keystroke_event *previous = nullptr;
+    for (const keystroke_event &event : keystrokes)
+    {
+        if (previous && previous->correct)
+        {
+            bigram_stats &bigram = this->stats[bigram_key(previous->expected, event.expected)];
+            const float latency_ms = (event.timestamp_ns - previous->timestamp_ns) / 1e6f;
+            bigram.attempts += 1.f;
+            bigram.mistakes += event.correct ? 0.f : 1.f;
+            bigram.latency_ms += latency_ms;
+            latency_sum += latency_ms;
+            ++latency_count;
+        }
+        previous = &event;
+    }
+    if (latency_count != 0)
+        this->mean_latency_ms = this->mean_latency_ms == 0.f ? latency_sum / latency_count
+                                                              : this->mean_latency_ms * ADAPTIVE_DECAY + latency_sum / latency_count * (1.f - ADAPTIVE_DECAY);
+    this->rebuild_table();
+}
+
+void AdaptiveSampler::rebuild_table()
+{
+    this->weighted_bigrams.clear();
+    std::vector<float> weights;
+    for (const auto &[key, bigram] : this->stats)
+    {
+        if (bigram.attempts <= 0.f || this->bigram_words.find(key) == this->bigram_words.end())
+            continue;
+        float weight = bigram.mistakes / (bigram.attempts + 1.f);
+        if (this->mean_latency_ms > 0.f)
+            weight += ADAPTIVE_LATENCY_WEIGHT * std::clamp(bigram.latency_ms / bigram.attempts / this->mean_latency_ms - 1.f, 0.f, 1.f);
+        if (weight <= 0.f)
+            continue;
+        this->weighted_bigrams.push_back(key);
+        weights.push_back(weight);
+    }
+    this->table.build(weights);
+}
+
+std::string_view AdaptiveSampler::sample(std::mt19937 &engine) const
+{
+    if (this->table.empty())
+        return std::string_view();
+    const std::vector<uint32_t> &candidates = this->bigram_words.at(this->weighted_bigrams[this->table.sample(engine)]);
+    std::uniform_int_distribution<std::size_t> pick(0, candidates.size() - 1);
+    return this->words[candidates[pick(engine)]];
+}
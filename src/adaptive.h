@@ -0,0 +1,83 @@
+#pragma once
+
+#include "keystrokes.h"
+#include "utf8.h"
+
+#include <cstdint>
+#include <random>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#define ADAPTIVE_SHARE 0.6f         // share of words picked for their weak bigrams, the rest is uniform
+#define ADAPTIVE_DECAY 0.8f         // weight of older tests when new statistics are learned
+#define ADAPTIVE_LATENCY_WEIGHT 0.5f // weight of being slower than average compared to the error rate
+
+/// @param a first codepoint
+/// @param b second codepoint
+/// @return key of the bigram
+inline uint64_t bigram_key(char32_t a, char32_t b) { return static_cast<uint64_t>(a) << 32 | b; }
+
+struct bigram_stats
+{
+    float attempts = 0.f;
+    float mistakes = 0.f;
+    float latency_ms = 0.f; // sum over attempts
+};
+
+/// @brief alias table (Vose) for sampling from a discrete distribution in O(1)
+class AliasTable
+{
+private:
+    std::vector<float> probability;
+    std::vector<uint32_t> alias;
+
+public:
+    /// @param weights non-negative weights, at least one positive
+    void build(const std::vector<float> &weights);
+
+    bool empty() const { return this->probability.empty(); }
+
+    void clear()
+    {
+        this->probability.clear();
+        this->alias.clear();
+    }
+
+    /// @return index picked with probability proportional to its weight
+    uint32_t sample(std::mt19937 &engine) const;
+};
+
+/// @brief picks words containing the bigrams the user types wrong or slowly
+class AdaptiveSampler
+{
+private:
+    std::vector<std::string_view> words;                          // stable order, index targets
+    std::unordered_map<uint64_t, std::vector<uint32_t>> bigram_words; // bigram -> words containing it
+    std::unordered_map<uint64_t, bigram_stats> stats;
+    float mean_latency_ms = 0.f;
+    std::vector<uint64_t> weighted_bigrams;
+    AliasTable table;
+
+    /// @brief rebuild alias table from current statistics (cost depends on the number of bigrams seen, not the corpus size)
+    void rebuild_table();
+
+public:
+    /// @brief index the corpus by bigram (of UTF-8 decoded codepoints)
+    /// @param corpus_words words of the corpus (views must outlive the sampler's use of them)
+    void index(const std::vector<std::string_view> &corpus_words);
+
+    /// @return true if the corpus is indexed
+    bool indexed() const { return !this->words.empty(); }
+
+    /// @brief drop the index (statistics are kept)
+    void clear_index();
+
+    /// @brief fold keystrokes of a finished test into bigram statistics and rebuild the alias table
+    /// @param keystrokes recorded keystrokes of the test
+    void learn(const KeystrokeRecorder &keystrokes);
+
+    /// @param engine random engine
+    /// @return word containing a weak bigram, empty view if there is no statistic to go by
+    std::string_view sample(std::mt19937 &engine) const;
+};
@@ -0,0 +1,137 @@
+#include "corpus.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+Corpus::~Corpus()
+{
+    this->clear();
+}
+
+bool Corpus::map(const std::string &filepath)
+{
+    this->clear();
+    int fd = open(filepath.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) < 0)
+    {
+        close(fd);
+        return false;
+    }
+    this->length = file_stat.st_size;
+    if (this->length == 0)
+    {
+        close(fd);
+        return true;
+    }
+
+    void *mapped = mmap(nullptr, this->length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED)
+    {
+        this->length = 0;
+        return false;
+    }
+    this->data = static_cast<const char *>(mapped);
+    return true;
+}
+
+bool Corpus::load(const std::string &filepath)
+{
+    std::error_code ec;
+    const std::filesystem::path path(filepath);
+    if (path.extension() == TTW_EXTENSION)
+        return this->load_compiled(filepath);
+
+    const std::string compiled_path = ttw_path_for(filepath);
+    if (std::filesystem::exists(compiled_path, ec) &&
+        std::filesystem::last_write_time(compiled_path, ec) >= std::filesystem::last_write_time(path, ec) &&
+        this->load_compiled(compiled_path))
+        return true;
+    return this->load_text(filepath);
+}
+
+bool Corpus::load_text(const std::string &filepath)
+{
+    if (!this->map(filepath))
+        return false;
+    if (!this->data)
+        return true;
+    madvise(const_cast<char *>(this->data), this->length, MADV_SEQUENTIAL);
+
+    const char *end = this->data + this->length;
+    this->word_views.reserve(std::count(this->data, end, '\n') + 1);
+    for (const char *begin = this->data; begin < end;)
+    {
+        const char *newline = static_cast<const char *>(std::memchr(begin, '\n', end - begin));
+        const char *line_end = newline ? newline : end;
+        std::size_t word_length = line_end - begin;
+        if (word_length > 0 && begin[word_length - 1] == '\r')
+            --word_length;
+        if (word_length > 0)
+            this->word_views.emplace_back(begin, word_length);
+        begin = line_end + 1;
+    }
+    return true;
+}
+
+bool Corpus::load_compiled(const std::string &filepath)
+{
+    if (!this->map(filepath))
+        return false;
+
+    ttw_header header;
+    if (this->length < sizeof(header))
+    {
+        this->clear();
+        return false;
+    }
+    std::memcpy(&header, this->data, sizeof(header));
+    const std::size_t offsets_size = (static_cast<std::size_t>(header.word_count) + 1) * sizeof(uint32_t);
+    //? sizes of a damaged header are checked one by one, their sum could wrap around
+    if (std::memcmp(header.magic, TTW_MAGIC, sizeof(header.magic)) != 0 || header.version != TTW_VERSION ||
+        offsets_size > this->length - sizeof(header) || header.blob_size > this->length - sizeof(header) - offsets_size)
+    {
+        this->clear();
+        return false;
+    }
+
+    this->offsets = reinterpret_cast<const uint32_t *>(this->data + sizeof(header));
+    this->blob = this->data + sizeof(header) + offsets_size;
+    if (this->offsets[header.word_count] != header.blob_size)
+    {
+        this->clear();
+        return false;
+    }
+
+    this->word_views.resize(header.word_count);
+    for (uint32_t i = 0; i < header.word_count; ++i)
+    {
+        if (this->offsets[i] > this->offsets[i + 1])
+        {
+            this->clear();
+            return false;
+        }
+        this->word_views[i] = std::string_view(this->blob + this->offsets[i], this->offsets[i + 1] - this->offsets[i]);
+    }
+    return true;
+}
+
+void Corpus::clear()
+{
+    this->word_views.clear();
+    if (this->data)
+        munmap(const_cast<char *>(this->data), this->length);
+    this->data = nullptr;
+    this->length = 0;
+    this->offsets = nullptr;
+    this->blob = nullptr;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "ttw.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+/// @brief read-only word list mapped into memory, every word is a view into the mapped file
+class Corpus
+{
+private:
+    const char *data = nullptr;
+    std::size_t length = 0;
+    std::vector<std::string_view> word_views;
+    const uint32_t *offsets = nullptr;
+    const char *blob = nullptr;
+
+    /// @brief map whole file into memory
+    /// @param filepath path to the file
+    /// @return true if the file was mapped (empty files are mapped with no data)
+    bool map(const std::string &filepath);
+
+public:
+    Corpus() = default;
+    ~Corpus();
+    Corpus(const Corpus &) = delete;
+    Corpus &operator=(const Corpus &) = delete;
+
+    /// @brief load word list, uses the precompiled .ttw next to a text list when it is up to date
+    /// @param filepath path to the word list (text or .ttw)
+    /// @return true if the list was loaded, on failure the corpus is left empty
+    bool load(const std::string &filepath);
+
+    /// @brief map given file and index its lines (one word per line, empty lines are skipped)
+    /// @param filepath path to the text word list
+    /// @return true if the file was mapped, on failure the corpus is left empty
+    bool load_text(const std::string &filepath);
+
+    /// @brief map given .ttw file and take its offsets table as is
+    /// @param filepath path to the precompiled word list
+    /// @return true if the file was mapped and is a valid .ttw, on failure the corpus is left empty
+    bool load_compiled(const std::string &filepath);
+
+    /// @brief unmap the file and drop all words
+    void clear();
+
+    /// @return number of indexed words
+    std::size_t size() const { return this->word_views.size(); }
+
+    /// @return true if the words come from a .ttw file
+    bool compiled() const { return this->blob != nullptr; }
+
+    /// @return views of all words, their order may be changed freely by the caller
+    std::vector<std::string_view> &words() { return this->word_views; }
+};
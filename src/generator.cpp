@@ -1,73 +1,169 @@
 #include "generator.h"
 
 bool Generator::initiated = false;
-std::vector<std::string> Generator::lines;
+Corpus Generator::corpus;
 Logger Generator::logger("generator.log", "generator.cpp");
+std::mt19937 Generator::engine(std::random_device{}());
+AdaptiveSampler Generator::adaptive;
+
+void Generator::seed(uint32_t seed)
+{
+    engine.seed(seed);
+    logger << "engine seeded with " + std::to_string(seed);
+}
 
 std::string Generator::generate(uint32_t amount)
 {
-    if (!initiated)
-        return std::string();
-    std::random_device rd;
-    std::mt19937 g(rd());
-    std::shuffle(lines.begin(), lines.end(), g);
+    std::string output;
+    generate(amount, output);
+    return output;
+}
+
+void Generator::generate(uint32_t amount, std::string &output)
+{
+    output.clear();
+    if (initiated)
+        append_words(amount, output);
+}
+
+uint32_t Generator::append_words(uint32_t amount, std::string &output)
+{
+    std::vector<std::string_view> &lines = corpus.words();
+    amount = std::min<std::size_t>(amount, lines.size());
 
-    std::stringstream ss;
     for (uint32_t i = 0; i < amount; ++i)
-        ss << lines[i] << " ";
-    std::string output = ss.str();
+    {
+        std::uniform_int_distribution<std::size_t> pick(i, lines.size() - 1);
+        std::swap(lines[i], lines[pick(engine)]);
+        if (i != 0)
+            output += ' ';
+        output += lines[i];
+    }
 
     logger << "generated " + std::to_string(amount) + " words";
+    return amount;
+}
 
-    return output.substr(0, output.length() - 1);
+std::string Generator::generate_adaptive(uint32_t amount)
+{
+    std::string output;
+    generate_adaptive(amount, output);
+    return output;
 }
 
-std::string Generator::get_text(std::string filepath)
+void Generator::generate_adaptive(uint32_t amount, std::string &output)
 {
-    std::ifstream file(filepath);
-    if (!file)
+    output.clear();
+    if (initiated)
+        append_adaptive_words(amount, output);
+}
+
+uint32_t Generator::append_adaptive_words(uint32_t amount, std::string &output)
+{
+    std::vector<std::string_view> &lines = corpus.words();
+    if (!adaptive.indexed())
     {
-        logger << "=ERROR= Unable to open file " + filepath;
-        return std::string();
+        auto begin = std::chrono::steady_clock::now();
+        adaptive.index(lines);
+        auto took = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin);
+        logger << "bigram index built in " + std::to_string(took.count()) + "us";
     }
-    std::string line;
-    std::getline(file, line);
-    logger << "text from " + filepath + " obtained";
-    return line;
+    amount = std::min<std::size_t>(amount, lines.size());
+
+    std::vector<std::string_view> picked;
+    picked.reserve(amount);
+    auto is_picked = [&picked](std::string_view word)
+    { return std::find(picked.begin(), picked.end(), word) != picked.end(); };
+    std::bernoulli_distribution weak(ADAPTIVE_SHARE);
+    uint32_t weak_count = 0;
+    std::size_t uniform_taken = 0;
+    while (picked.size() < amount)
+    {
+        std::string_view word;
+        if (weak(engine))
+            word = adaptive.sample(engine);
+        if (!word.empty() && !is_picked(word))
+            ++weak_count;
+        else
+        {
+            if (uniform_taken == lines.size())
+                break;
+            std::uniform_int_distribution<std::size_t> pick(uniform_taken, lines.size() - 1);
+            std::swap(lines[uniform_taken], lines[pick(engine)]);
+            word = lines[uniform_taken++];
+            if (is_picked(word))
+                continue;
+        }
+        picked.push_back(word);
+    }
+
+    for (std::size_t i = 0; i < picked.size(); ++i)
+    {
+        if (i != 0)
+            output += ' ';
+        output += picked[i];
+    }
+
+    logger << "generated " + std::to_string(picked.size()) + " words (" + std::to_string(weak_count) + " for weak bigrams)";
+    return picked.size();
 }
 
-void Generator::init(std::string filepath)
+bool Generator::generate_batch(uint32_t amount, std::string &output, bool adaptive)
 {
-    if (initiated)
-        return;
+    if (!initiated || (adaptive ? append_adaptive_words(amount, output) : append_words(amount, output)) == 0)
+        return false;
+    output += ' ';
+    return true;
+}
+
+void Generator::learn(const KeystrokeRecorder &keystrokes)
+{
+    adaptive.learn(keystrokes);
+}
+
+std::string Generator::get_text(std::string filepath)
+{
+    std::string output;
+    get_text(filepath, output);
+    return output;
+}
+
+void Generator::get_text(const std::string &filepath, std::string &output)
+{
+    output.clear();
     std::ifstream file(filepath);
     if (!file)
     {
         logger << "=ERROR= Unable to open file " + filepath;
         return;
     }
-
-    std::string line;
-    while (std::getline(file, line))
-        lines.push_back(line);
-    initiated = true;
-    logger << "generator initiated with file " + filepath;
+    std::getline(file, output);
+    logger << "text from " + filepath + " obtained";
 }
 
-void Generator::change_file(std::string filepath)
+void Generator::load(const std::string &filepath)
 {
     initiated = false;
-    std::ifstream file(filepath);
-    if (!file)
+    adaptive.clear_index();
+    auto begin = std::chrono::steady_clock::now();
+    if (!corpus.load(filepath))
     {
         logger << "=ERROR= Unable to open file " + filepath;
         return;
     }
-
-    lines.clear();
-    std::string line;
-    while (std::getline(file, line))
-        lines.push_back(line);
+    auto took = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin);
     initiated = true;
-    logger << "generator initiated with file " + filepath;
+    logger << "generator initiated with file " + filepath + " (" + std::to_string(corpus.size()) + (corpus.compiled() ? " precompiled" : "") + " words in " + std::to_string(took.count()) + "us)";
+}
+
+void Generator::init(std::string filepath)
+{
+    if (initiated)
+        return;
+    load(filepath);
+}
+
+void Generator::change_file(std::string filepath)
+{
+    load(filepath);
 }
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "logger.h"
+#include "corpus.h"
+#include "adaptive.h"
 
 #include <iostream>
 #include <vector>
@@ -9,18 +11,82 @@
 #include <algorithm>
 #include <sstream>
 
+#define WORD_BATCH_SIZE 50 // words generated at once for the endless word stream of timed tests
+
 class Generator
 {
 private:
-    static std::vector<std::string> lines;
+    static Corpus corpus;
     static bool initiated;
     static Logger logger;
+    static std::mt19937 engine;
+    static AdaptiveSampler adaptive;
+
+    /// @brief (re)load the corpus from given file and log the time it took
+    /// @param filepath path to the word list
+    static void load(const std::string &filepath);
+
+    /// @brief append given amount of distinct random words separated with spaces (the corpus has to be loaded)
+    /// @param amount number of words (clamped to the number of loaded words)
+    /// @param output the words are appended to it
+    /// @return number of appended words
+    static uint32_t append_words(uint32_t amount, std::string &output);
+
+    /// @brief append words picked as generate_adaptive() does, separated with spaces (the corpus has to be loaded)
+    /// @param amount number of words (clamped to the number of loaded words)
+    /// @param output the words are appended to it
+    /// @return number of appended words
+    static uint32_t append_adaptive_words(uint32_t amount, std::string &output);
 
 public:
     Generator() = delete;
 
     static void init(std::string filepath = "txt/words.txt");
     static void change_file(std::string filepath);
+
+    /// @return number of loaded words (0 if no file is loaded)
+    static std::size_t size() { return initiated ? corpus.size() : 0; }
+
+    /// @brief reseed the word sampling engine, runs with the same seed and file produce the same goals
+    /// @param seed value the engine is seeded with
+    static void seed(uint32_t seed);
+
+    /// @brief pick given amount of distinct random words, only the picked words are shuffled (partial Fisher-Yates)
+    /// @param amount number of words (clamped to the number of loaded words)
+    /// @return picked words separated with spaces
     static std::string generate(uint32_t amount);
+
+    /// @brief same as generate(amount), writes into given string reusing its buffer
+    /// @param amount number of words (clamped to the number of loaded words)
+    /// @param output replaced with picked words separated with spaces
+    static void generate(uint32_t amount, std::string &output);
+
+    /// @brief pick given amount of distinct words, about ADAPTIVE_SHARE of them contain bigrams the user types wrong or slowly
+    /// (the bigram index is built on the first call after loading a file)
+    /// @param amount number of words (clamped to the number of loaded words)
+    /// @return picked words separated with spaces
+    static std::string generate_adaptive(uint32_t amount);
+
+    /// @brief same as generate_adaptive(amount), writes into given string reusing its buffer
+    /// @param amount number of words (clamped to the number of loaded words)
+    /// @param output replaced with picked words separated with spaces
+    static void generate_adaptive(uint32_t amount, std::string &output);
+
+    /// @brief next batch of an endless word stream (timed mode): appends given amount of picked words, each followed
+    /// by a space so consecutive batches join into one text
+    /// @param amount number of words (clamped to the number of loaded words)
+    /// @param output the batch is appended to it
+    /// @param adaptive pick words as generate_adaptive() does
+    /// @return false if no file is loaded
+    static bool generate_batch(uint32_t amount, std::string &output, bool adaptive = false);
+
+    /// @brief update weak bigram statistics with keystrokes of a finished test
+    /// @param keystrokes recorded keystrokes of the test
+    static void learn(const KeystrokeRecorder &keystrokes);
     static std::string get_text(std::string filepath);
-};
\ No newline at end of file
+
+    /// @brief same as get_text(filepath), writes into given string reusing its buffer
+    /// @param filepath path to the text file
+    /// @param output replaced with the first line of the file ("" if the file can't be opened)
+    static void get_text(const std::string &filepath, std::string &output);
+};
@@ -0,0 +1,153 @@
+#include "input.h"
+#include "utf8.h"
+
+void KeyDecoder::ground(unsigned char byte)
+{
+    switch (byte)
+    {
+    case 0x1B:
+        this->state = decoder_state::ESCAPE;
+        return;
+    case '\n':
+    case '\r':
+        return this->emit(key_type::ENTER);
+    case '\t':
+        return this->emit(key_type::TAB);
+    case '\b':
+    case 0x7F:
+        return this->emit(key_type::BACKSPACE);
+    }
+    if (byte >= 0x80)
+    {
+        this->sequence_length = 0;
+        this->state = decoder_state::UTF8;
+        this->feed(byte);
+    }
+    else if (byte >= 0x20)
+        this->emit({key_type::CHARACTER, byte});
+    else
+        this->emit(key_type::UNKNOWN);
+}
+
+key_type KeyDecoder::sequence_key(unsigned char final) const
+{
+    switch (final)
+    {
+    case 'A':
+        return key_type::UP;
+    case 'B':
+        return key_type::DOWN;
+    case 'C':
+        return key_type::RIGHT;
+    case 'D':
+        return key_type::LEFT;
+    case 'H':
+        return key_type::HOME;
+    case 'F':
+        return key_type::END;
+    case '~':
+        switch (this->parameter)
+        {
+        case 1:
+        case 7:
+            return key_type::HOME;
+        case 4:
+        case 8:
+            return key_type::END;
+        case 3:
+            return key_type::DELETE;
+        case 5:
+            return key_type::PAGE_UP;
+        case 6:
+            return key_type::PAGE_DOWN;
+        }
+    }
+    return key_type::UNKNOWN;
+}
+
+void KeyDecoder::feed(unsigned char byte)
+{
+    switch (this->state)
+    {
+    case decoder_state::GROUND:
+        return this->ground(byte);
+
+    case decoder_state::ESCAPE:
+        if (byte == '[' || byte == 'O')
+        {
+            this->state = byte == '[' ? decoder_state::CSI : decoder_state::SS3;
+            this->parameter = 0;
+            this->sequence_length = 0;
+            return;
+        }
+        //? ESC followed by anything else was the escape key pressed right before another key
+        this->emit(key_type::ESCAPE);
+        this->state = decoder_state::GROUND;
+        return this->ground(byte);
+
+    case decoder_state::CSI:
+        if (byte >= '0' && byte <= '9' && this->sequence_length == 0)
+            this->parameter = this->parameter * 10 + (byte - '0');
+        else if (byte >= 0x20 && byte <= 0x3F)
+            this->sequence_length = 1; // further parameters and intermediates are not needed
+        else
+        {
+            this->state = decoder_state::GROUND;
+            if (byte >= 0x40 && byte <= 0x7E)
+                return this->emit(this->sequence_key(byte));
+            this->emit(key_type::UNKNOWN);
+            return this->ground(byte);
+        }
+        return;
+
+    case decoder_state::SS3:
+        this->state = decoder_state::GROUND;
+        if (byte >= 0x40 && byte <= 0x7E)
+            return this->emit(this->sequence_key(byte));
+        this->emit(key_type::UNKNOWN);
+        return this->ground(byte);
+
+    case decoder_state::UTF8:
+        if (this->sequence_length > 0 && (byte & 0xC0) != 0x80)
+        {
+            this->emit({key_type::CHARACTER, REPLACEMENT_CHARACTER});
+            this->state = decoder_state::GROUND;
+            return this->ground(byte);
+        }
+        this->sequence[this->sequence_length++] = byte;
+        char32_t codepoint;
+        if (decode_utf8(this->sequence, this->sequence + this->sequence_length, codepoint) != 0)
+        {
+            this->emit({key_type::CHARACTER, codepoint});
+            this->state = decoder_state::GROUND;
+        }
+        return;
+    }
+}
+
+void KeyDecoder::timeout()
+{
+    switch (this->state)
+    {
+    case decoder_state::GROUND:
+        return;
+    case decoder_state::ESCAPE:
+        this->emit(key_type::ESCAPE);
+        break;
+    case decoder_state::UTF8:
+        this->emit({key_type::CHARACTER, REPLACEMENT_CHARACTER});
+        break;
+    default:
+        this->emit(key_type::UNKNOWN);
+        break;
+    }
+    this->state = decoder_state::GROUND;
+}
+
+bool KeyDecoder::next(key_event &event)
+{
+    if (!this->ready())
+        return false;
+    event = this->queue[this->queue_begin++ % KEY_QUEUE_SIZE];
+    return true;
+}
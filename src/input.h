@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#define ESCAPE_TIMEOUT_MS 25 // a lone ESC is the escape key if nothing follows it within this time
+#define KEY_QUEUE_SIZE 4
+
+enum class key_type
+{
+    NONE, // no input (stdin closed)
+    CHARACTER,
+    ENTER,
+    ESCAPE,
+    BACKSPACE,
+    TAB,
+    UP,
+    DOWN,
+    RIGHT,
+    LEFT,
+    HOME,
+    END,
+    DELETE,
+    PAGE_UP,
+    PAGE_DOWN,
+    UNKNOWN // escape sequence of a key the app doesn't use
+};
+
+struct key_event
+{
+    key_type type;
+    char32_t codepoint; // typed character for key_type::CHARACTER, else 0
+
+    /// @param c character
+    /// @return true if given character was typed
+    bool is(char32_t c) const { return this->type == key_type::CHARACTER && this->codepoint == c; }
+};
+
+/// @brief finite-state parser turning raw terminal bytes into key events (UTF-8 characters, control keys,
+/// CSI and SS3 escape sequences), every byte is fed exactly once
+class KeyDecoder
+{
+private:
+    enum class decoder_state
+    {
+        GROUND,
+        ESCAPE, // after ESC
+        CSI,    // after ESC [
+        SS3,    // after ESC O
+        UTF8    // inside a multibyte character
+    };
+
+    decoder_state state = decoder_state::GROUND;
+    char sequence[4];           // bytes of the multibyte character
+    std::size_t sequence_length = 0;
+    uint32_t parameter = 0;     // first numeric CSI parameter
+    key_event queue[KEY_QUEUE_SIZE];
+    std::size_t queue_begin = 0, queue_end = 0;
+
+    /// @param event decoded key
+    void emit(key_event event) { this->queue[this->queue_end++ % KEY_QUEUE_SIZE] = event; }
+
+    /// @param type decoded key without a character
+    void emit(key_type type) { this->emit({type, 0}); }
+
+    /// @brief handle byte outside any sequence
+    void ground(unsigned char byte);
+
+    /// @param final final byte of a CSI or SS3 sequence
+    /// @return key the sequence stands for
+    key_type sequence_key(unsigned char final) const;
+
+public:
+    /// @brief parse next input byte, decoded keys become available through next()
+    /// @param byte raw byte read from the terminal
+    void feed(unsigned char byte);
+
+    /// @brief no more bytes came in time, a started sequence is decoded as far as it goes (a lone ESC is the escape key)
+    void timeout();
+
+    /// @return true if a started sequence waits for further bytes
+    bool pending() const { return this->state != decoder_state::GROUND; }
+
+    /// @return true if a decoded key is waiting
+    bool ready() const { return this->queue_begin != this->queue_end; }
+
+    /// @param event oldest decoded key
+    /// @return false if no key is waiting
+    bool next(key_event &event);
+};
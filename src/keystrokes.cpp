@@ -0,0 +1,73 @@
+#include "keystrokes.h"
+
+#include <algorithm>
+
+float keystroke_summary::error_rate(char32_t c) const
+{
+    const auto attempt = this->attempts.find(c), mistake = this->mistakes.find(c);
+    if (attempt == this->attempts.end() || mistake == this->mistakes.end())
+        return 0.f;
+    return (float)mistake->second / attempt->second;
+}
+
+char32_t keystroke_summary::weakest_character() const
+{
+    char32_t weakest = 0;
+    float highest_rate = 0.f;
+    for (const auto &[c, mistakes] : this->mistakes)
+    {
+        float rate = this->error_rate(c);
+        if (rate > highest_rate || (rate == highest_rate && c < weakest))
+        {
+            highest_rate = rate;
+            weakest = c;
+        }
+    }
+    return weakest;
+}
+
+KeystrokeRecorder::KeystrokeRecorder(std::size_t capacity) : events(new keystroke_event[capacity]), capacity(capacity) {}
+
+keystroke_summary KeystrokeRecorder::summarize() const
+{
+    keystroke_summary summary;
+    summary.keystrokes = this->count;
+    summary.dropped = this->dropped;
+
+    uint64_t latency_sum_ns = 0;
+    uint64_t correct_timestamps[BURST_WINDOW + 1];
+    std::size_t correct_count = 0;
+    for (std::size_t i = 0; i < this->count; ++i)
+    {
+        const keystroke_event &event = this->events[i];
+        const char32_t expected = event.expected;
+        ++summary.attempts[expected];
+        if (!event.correct)
+        {
+            ++summary.errors;
+            ++summary.mistakes[expected];
+        }
+
+        if (i > 0)
+        {
+            const uint64_t latency_ns = event.timestamp_ns - this->events[i - 1].timestamp_ns;
+            latency_sum_ns += latency_ns;
+            std::size_t bucket = latency_ns / 1000000 / LATENCY_BUCKET_MS;
+            ++summary.latency_histogram[bucket < LATENCY_BUCKETS ? bucket : LATENCY_BUCKETS - 1];
+        }
+
+        if (event.correct)
+        {
+            correct_timestamps[correct_count % (BURST_WINDOW + 1)] = event.timestamp_ns;
+            if (++correct_count > BURST_WINDOW)
+            {
+                const uint64_t window_ns = event.timestamp_ns - correct_timestamps[correct_count % (BURST_WINDOW + 1)];
+                if (window_ns > 0)
+                    summary.burst_wpm = std::max(summary.burst_wpm, (BURST_WINDOW / 5.f) / (window_ns / 60e9f));
+            }
+        }
+    }
+    if (this->count > 1)
+        summary.mean_latency_ms = latency_sum_ns / 1e6f / (this->count - 1);
+    return summary;
+}
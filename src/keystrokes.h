@@ -0,0 +1,80 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#define KEYSTROKE_CAPACITY 65536
+#define LATENCY_BUCKET_MS 25
+#define LATENCY_BUCKETS 40 // the last bucket also collects everything slower
+#define BURST_WINDOW 10    // correct characters burst WPM is measured over
+
+struct keystroke_event
+{
+    uint64_t timestamp_ns;
+    char32_t expected; // codepoints, a grapheme of several codepoints takes several keystrokes
+    char32_t typed;
+    bool correct;
+};
+
+struct keystroke_summary
+{
+    uint32_t keystrokes = 0;
+    uint32_t errors = 0;
+    uint32_t dropped = 0;
+    std::array<uint32_t, LATENCY_BUCKETS> latency_histogram = {};
+    float mean_latency_ms = 0.f;
+    float burst_wpm = 0.f;
+    std::unordered_map<char32_t, uint32_t> attempts; // keystrokes per expected codepoint
+    std::unordered_map<char32_t, uint32_t> mistakes; // wrong keystrokes per expected codepoint
+
+    /// @param c expected codepoint
+    /// @return fraction of wrong keystrokes when given codepoint was expected
+    float error_rate(char32_t c) const;
+
+    /// @return codepoint with the highest error rate (0 if there were no errors)
+    char32_t weakest_character() const;
+};
+
+/// @brief records every keystroke of a test into a buffer allocated once, recording never allocates
+class KeystrokeRecorder
+{
+private:
+    std::unique_ptr<keystroke_event[]> events;
+    std::size_t capacity;
+    std::size_t count = 0;
+    uint32_t dropped = 0;
+
+public:
+    /// @param capacity maximum number of keystrokes kept per test, following ones are only counted
+    explicit KeystrokeRecorder(std::size_t capacity = KEYSTROKE_CAPACITY);
+
+    /// @brief forget recorded keystrokes (keeps the buffer)
+    void clear()
+    {
+        this->count = 0;
+        this->dropped = 0;
+    }
+
+    /// @param timestamp_ns steady clock time of the keystroke in nanoseconds
+    /// @param expected codepoint the goal expected
+    /// @param typed codepoint the user typed
+    void record(uint64_t timestamp_ns, char32_t expected, char32_t typed) noexcept
+    {
+        if (this->count < this->capacity)
+            this->events[this->count++] = {timestamp_ns, expected, typed, expected == typed};
+        else
+            ++this->dropped;
+    }
+
+    /// @return number of recorded keystrokes
+    std::size_t size() const { return this->count; }
+
+    const keystroke_event *begin() const { return this->events.get(); }
+    const keystroke_event *end() const { return this->events.get() + this->count; }
+
+    /// @return inter-key latency histogram, burst WPM and per-character error rates of recorded keystrokes
+    keystroke_summary summarize() const;
+};
@@ -1,6 +1,95 @@
 #include "logger.h"
 
-Logger::Logger(std::string log_filename, std::string filename) : filename(filename)
+#include <cstring>
+
+LogWriter::LogWriter() : worker(&LogWriter::work, this) {}
+
+LogWriter::~LogWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->running = false;
+    }
+    this->wake_writer.notify_one();
+    this->worker.join();
+}
+
+LogWriter &LogWriter::instance()
+{
+    static LogWriter writer;
+    return writer;
+}
+
+void LogWriter::push(log_record &&record)
+{
+    while (!this->queue.try_push(record))
+    {
+        this->wake_writer.notify_one();
+        std::this_thread::yield();
+    }
+    if (this->pushed.fetch_add(1, std::memory_order_release) % (LOG_QUEUE_CAPACITY / 2) == LOG_QUEUE_CAPACITY / 2 - 1)
+        this->wake_writer.notify_one();
+}
+
+void LogWriter::flush()
+{
+    const uint64_t target = this->pushed.load(std::memory_order_acquire);
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->wake_writer.notify_one();
+    this->wake_flushers.wait(lock, [this, target]
+                             { return this->written >= target; });
+}
+
+void LogWriter::work()
+{
+    log_record record;
+    Logger *touched[LOG_BATCH_SIZE];
+    while (true)
+    {
+        std::size_t batch = 0, touched_count = 0;
+        while (batch < LOG_BATCH_SIZE && this->queue.try_pop(record))
+        {
+            record.target->write(record.time, record.message);
+            if (std::find(touched, touched + touched_count, record.target) == touched + touched_count)
+                touched[touched_count++] = record.target;
+            ++batch;
+        }
+        for (std::size_t i = 0; i < touched_count; ++i)
+            touched[i]->log_file.flush();
+
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->written += batch;
+        if (batch != 0)
+        {
+            this->wake_flushers.notify_all();
+            continue;
+        }
+        if (!this->running && this->written >= this->pushed.load(std::memory_order_acquire))
+            return;
+        this->wake_writer.wait_for(lock, LOG_IDLE_WAIT);
+    }
+}
+
+std::string_view TimestampCache::format(std::chrono::system_clock::time_point time)
+{
+    const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count();
+    const std::time_t current_second = ms / 1000;
+    if (current_second != this->second)
+    {
+        std::tm local_time;
+        localtime_r(&current_second, &local_time);
+        std::strftime(this->text, sizeof(this->text), "%H:%M:%S.000-%Y-%m-%d", &local_time);
+        this->length = std::strlen(this->text);
+        this->second = current_second;
+    }
+    const int millis = ms % 1000;
+    this->text[9] = '0' + millis / 100;
+    this->text[10] = '0' + millis / 10 % 10;
+    this->text[11] = '0' + millis % 10;
+    return std::string_view(this->text, this->length);
+}
+
+Logger::Logger(std::string log_filename, std::string filename, bool async, log_format format) : filename(filename), async(async), format(format)
 {
     std::string dir_path = "logs";
     if (!std::filesystem::exists(dir_path))
@@ -9,14 +98,78 @@ Logger::Logger(std::string log_filename, std::string filename) : filename(filena
             std::cerr << "Failed to create logs directory \"" << dir_path << "\"" << std::endl;
     }
 
-    std::string log_filepath = dir_path + "/" + log_filename;
-    log_file.open(log_filepath.c_str(), std::ios_base::out | std::ios_base::app);
+    std::filesystem::path log_filepath = std::filesystem::path(dir_path) / log_filename;
+    if (this->format == log_format::BINARY)
+    {
+        log_filepath.replace_extension(LOG_BINARY_EXTENSION);
+        log_file.open(log_filepath, std::ios_base::out | std::ios_base::app | std::ios_base::binary);
+        if (log_file.is_open() && log_file.tellp() == 0)
+        {
+            log_file.write(LOG_BINARY_MAGIC, 4);
+            log_file.put(LOG_BINARY_VERSION);
+        }
+    }
+    else
+        log_file.open(log_filepath, std::ios_base::out | std::ios_base::app);
     if (!log_file.is_open())
-        std::cerr << "Failed to open log file \"" << log_filepath << "\"" << std::endl;
+        std::cerr << "Failed to open log file \"" << log_filepath.string() << "\"" << std::endl;
+    if (this->async)
+        LogWriter::instance();
 }
 
 Logger::~Logger()
 {
+    if (this->async)
+        LogWriter::instance().flush();
     if (log_file.is_open())
         log_file.close();
-}
\ No newline at end of file
+}
+
+void Logger::flush_all()
+{
+    LogWriter::instance().flush();
+}
+
+log_format Logger::default_format()
+{
+    const char *format = std::getenv(LOG_FORMAT_ENV);
+    return format && std::string(format) == "binary" ? log_format::BINARY : log_format::TEXT;
+}
+
+void Logger::log(std::string &&message)
+{
+    auto now = std::chrono::system_clock::now();
+    if (this->async)
+        LogWriter::instance().push({this, now, std::move(message)});
+    else
+    {
+        this->write(now, message);
+        log_file.flush();
+    }
+}
+
+void Logger::write(std::chrono::system_clock::time_point time, const std::string &message)
+{
+    if (this->format == log_format::TEXT)
+    {
+        log_file << "[" << this->timestamp.format(time) << "] " << this->filename << ": " << message << '\n';
+        return;
+    }
+
+    const int64_t ms = std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count();
+    this->record.clear();
+    if (this->last_record_ms < 0 || ms < this->last_record_ms)
+    {
+        this->record += static_cast<char>(LOG_RECORD_SESSION);
+        append_varint(this->record, ms);
+        append_varint(this->record, this->filename.size());
+        this->record += this->filename;
+        this->last_record_ms = ms;
+    }
+    this->record += static_cast<char>(LOG_RECORD_MESSAGE);
+    append_varint(this->record, ms - this->last_record_ms);
+    append_varint(this->record, message.size());
+    this->record += message;
+    this->last_record_ms = ms;
+    log_file.write(this->record.data(), this->record.size());
+}
@@ -1,35 +1,151 @@
 #pragma once
 
+#include "ring_buffer.h"
+#include "varint.h"
+
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <chrono>
 #include <ctime>
 #include <iomanip>
 #include <filesystem>
+#include <sstream>
+#include <string_view>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#define LOG_QUEUE_CAPACITY 1024
+#define LOG_BATCH_SIZE 64
+#define LOG_IDLE_WAIT std::chrono::milliseconds(20)
+
+#define LOG_FORMAT_ENV "TERMINALTYPER_LOG_FORMAT"
+#define LOG_BINARY_EXTENSION ".bin"
+#define LOG_BINARY_MAGIC "TLOG"
+#define LOG_BINARY_VERSION 1
+#define LOG_RECORD_SESSION 1 // varint absolute ms since epoch, varint source length, source
+#define LOG_RECORD_MESSAGE 2 // varint ms since the previous record, varint message length, message
+
+enum class log_format
+{
+    TEXT,
+    BINARY
+};
+
+/// @brief formats log timestamps, the date and time of day part is reformatted only when the second changes
+class TimestampCache
+{
+private:
+    std::time_t second = -1;
+    char text[32];
+    std::size_t length = 0;
+
+public:
+    /// @param time moment to be formatted
+    /// @return "HH:MM:SS.mmm-YYYY-MM-DD", valid until the next call
+    std::string_view format(std::chrono::system_clock::time_point time);
+};
+
+class Logger;
+
+struct log_record
+{
+    Logger *target;
+    std::chrono::system_clock::time_point time;
+    std::string message;
+};
+
+/// @brief background thread shared by all asynchronous loggers, formats queued records and writes them in batches
+class LogWriter
+{
+private:
+    RingBuffer<log_record, LOG_QUEUE_CAPACITY> queue;
+    std::atomic<uint64_t> pushed{0};
+    uint64_t written = 0;
+    bool running = true;
+    std::mutex mutex;
+    std::condition_variable wake_writer, wake_flushers;
+    std::thread worker;
+
+    LogWriter();
+    ~LogWriter();
+
+    /// @brief writer thread body
+    void work();
+
+public:
+    LogWriter(const LogWriter &) = delete;
+    LogWriter &operator=(const LogWriter &) = delete;
+
+    /// @return writer shared by all loggers, started on first use
+    static LogWriter &instance();
+
+    /// @brief queue record for writing, waits for a free slot only when the queue is full
+    /// @param record record to be written
+    void push(log_record &&record);
+
+    /// @brief block until every record queued before the call is written and flushed to its file
+    void flush();
+};
 
 class Logger
 {
+    friend class LogWriter;
+
 public:
-    Logger(std::string log_filename, std::string filename);
+    /// @param log_filename file in logs/ directory the messages are appended to
+    /// @param filename source name every message is tagged with
+    /// @param async if true messages are written by the background LogWriter, else synchronously
+    /// @param format TEXT appends readable lines, BINARY appends compact records to the file with .bin extension (see tools/decode_log.cpp)
+    Logger(std::string log_filename, std::string filename, bool async = true, log_format format = Logger::default_format());
     ~Logger();
 
     template <typename T>
     Logger &operator<<(const T &message)
     {
-        std::time_t currentTime = std::time(nullptr);
-        std::tm localTime = *std::localtime(&currentTime);
+        std::ostringstream ss;
+        ss << message;
+        this->log(ss.str());
+        return *this;
+    }
 
-        log_file << "[" << std::put_time(&localTime, "%H:%M:%S-%Y-%m-%d") << "] " << this->filename << ": " << message << std::endl;
+    Logger &operator<<(const std::string &message)
+    {
+        this->log(std::string(message));
         return *this;
     }
 
+    /// @brief manipulators go straight to the file, so everything queued is written first
     Logger &operator<<(std::ostream &(*manipulator)(std::ostream &))
     {
+        if (this->async)
+            Logger::flush_all();
         log_file << manipulator;
         return *this;
     }
 
+    /// @brief block until every queued message of every logger is written to disk
+    static void flush_all();
+
+    /// @return BINARY if LOG_FORMAT_ENV environment variable is set to "binary", else TEXT
+    static log_format default_format();
+
 private:
     std::ofstream log_file;
     std::string filename;
+    bool async;
+    log_format format;
+    TimestampCache timestamp;
+    int64_t last_record_ms = -1;
+    std::string record;
+
+    /// @brief queue or write message with current time
+    /// @param message text of the log line
+    void log(std::string &&message);
+
+    /// @brief format one log line or binary record into the file (no flush)
+    /// @param time moment the message was logged
+    /// @param message text of the log line
+    void write(std::chrono::system_clock::time_point time, const std::string &message);
 };
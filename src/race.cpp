@@ -0,0 +1,450 @@
+#include "race.h"
+#include "generator.h"
+#include "settings.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace
+{
+    RaceServer *running_server = nullptr;
+
+    void handle_stop(int)
+    {
+        if (running_server)
+            running_server->stop();
+    }
+
+    /// @param path socket path
+    /// @param address filled with the address of the path
+    /// @return false if the path is too long
+    bool make_address(const std::string &path, sockaddr_un &address)
+    {
+        address = {};
+        address.sun_family = AF_UNIX;
+        if (path.empty() || path.size() >= sizeof(address.sun_path))
+            return false;
+        std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+        return true;
+    }
+
+    /// @brief take complete lines out of the buffer
+    /// @param buffer read bytes, the unfinished line is left in it
+    /// @param handle called with every line (without the newline)
+    template <typename F>
+    void split_lines(std::string &buffer, F handle)
+    {
+        std::size_t begin = 0, end;
+        while ((end = buffer.find('\n', begin)) != std::string::npos)
+        {
+            handle(buffer.substr(begin, end - begin));
+            begin = end + 1;
+        }
+        buffer.erase(0, begin);
+    }
+}
+
+RaceServer::RaceServer(std::string socket_path) : socket_path(std::move(socket_path)), logger("race.log", "race.cpp") {}
+
+RaceServer::~RaceServer()
+{
+    for (auto &[fd, r] : this->racers)
+        close(fd);
+    for (int fd : {this->listen_fd, this->epoll_fd, this->wake_fd})
+        if (fd >= 0)
+            close(fd);
+    if (this->listen_fd >= 0)
+        unlink(this->socket_path.c_str());
+}
+
+bool RaceServer::listen(std::string &error)
+{
+    sockaddr_un address;
+    if (!make_address(this->socket_path, address))
+    {
+        error = "invalid socket path " + this->socket_path;
+        return false;
+    }
+    if (Generator::size() == 0)
+    {
+        error = "no words to generate goals from";
+        return false;
+    }
+    this->listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    this->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    this->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (this->listen_fd < 0 || this->epoll_fd < 0 || this->wake_fd < 0)
+    {
+        error = std::string("unable to create the server: ") + std::strerror(errno);
+        return false;
+    }
+    //? a socket file left by a crashed server would make bind() fail
+    unlink(this->socket_path.c_str());
+    if (bind(this->listen_fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0 ||
+        ::listen(this->listen_fd, SOMAXCONN) < 0)
+    {
+        error = "unable to listen on " + this->socket_path + ": " + std::strerror(errno);
+        close(this->listen_fd);
+        this->listen_fd = -1;
+        return false;
+    }
+    for (int fd : {this->listen_fd, this->wake_fd})
+    {
+        epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        epoll_ctl(this->epoll_fd, EPOLL_CTL_ADD, fd, &event);
+    }
+    Generator::generate(RACE_WORDS, this->goal);
+    this->logger << "listening on " + this->socket_path;
+    return true;
+}
+
+void RaceServer::accept_racers()
+{
+    int fd;
+    while ((fd = accept4(this->listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0)
+    {
+        epoll_event event = {};
+        event.events = EPOLLIN | EPOLLRDHUP;
+        event.data.fd = fd;
+        if (epoll_ctl(this->epoll_fd, EPOLL_CTL_ADD, fd, &event) < 0)
+        {
+            close(fd);
+            continue;
+        }
+        racer &r = this->racers[fd];
+        r.id = this->next_id++;
+        //? late racers get the current race and the progress made in it so far
+        r.output = "W " + std::to_string(r.id) + "\nG " + std::to_string(this->round) + " " + this->goal + "\n";
+        for (const auto &[id, score] : this->scores)
+            r.output += "P " + std::to_string(id) + " " + std::to_string(this->round) + " " + std::to_string(score) + "\n";
+        this->scores[r.id] = 0;
+        this->logger << "racer " + std::to_string(r.id) + " joined";
+    }
+    if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+        this->logger << std::string("=ERROR= accept() failed: ") + std::strerror(errno);
+}
+
+bool RaceServer::read_racer(int fd, racer &r)
+{
+    char buffer[4096];
+    ssize_t count;
+    while ((count = read(fd, buffer, sizeof(buffer))) > 0)
+        r.input.append(buffer, count);
+    if (count == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR))
+        return false;
+
+    split_lines(r.input, [&](const std::string &message)
+                {
+        if (message == "N")
+        {
+            r.ready = true;
+            r.idle = false;
+        }
+        else if (message == "I")
+        {
+            r.ready = false;
+            r.idle = true;
+        }
+        else if (message.size() > 2 && message.compare(0, 2, "P ") == 0)
+        {
+            r.idle = false;
+            const uint32_t score = std::strtoul(message.c_str() + 2, nullptr, 10);
+            this->scores[r.id] = score;
+            this->updates += "P " + std::to_string(r.id) + " " + std::to_string(this->round) + " " + std::to_string(score) + "\n";
+        } });
+    //? a racer sending garbage without newlines can't make the server grow without bounds
+    return r.input.size() <= RACE_MAX_PENDING;
+}
+
+bool RaceServer::flush(int fd, racer &r)
+{
+    std::size_t sent = 0;
+    while (sent < r.output.size())
+    {
+        ssize_t count = send(fd, r.output.data() + sent, r.output.size() - sent, MSG_NOSIGNAL);
+        if (count < 0 && errno == EINTR)
+            continue;
+        if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            break;
+        if (count < 0)
+            return false;
+        sent += count;
+    }
+    r.output.erase(0, sent);
+    if (r.output.size() > RACE_MAX_PENDING)
+        return false;
+
+    if (r.output.empty() == r.watching_output)
+    {
+        r.watching_output = !r.output.empty();
+        epoll_event event = {};
+        event.events = EPOLLIN | EPOLLRDHUP | (r.watching_output ? static_cast<uint32_t>(EPOLLOUT) : 0);
+        event.data.fd = fd;
+        epoll_ctl(this->epoll_fd, EPOLL_CTL_MOD, fd, &event);
+    }
+    return true;
+}
+
+void RaceServer::drop(int fd)
+{
+    auto found = this->racers.find(fd);
+    if (found == this->racers.end())
+        return;
+    const uint32_t id = found->second.id;
+    epoll_ctl(this->epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+    close(fd);
+    this->racers.erase(found);
+    this->scores.erase(id);
+    this->updates += "L " + std::to_string(id) + "\n";
+    this->logger << "racer " + std::to_string(id) + " left";
+}
+
+void RaceServer::start_round_if_ready()
+{
+    //? racers in the menu would hold the others in the lobby forever, only the ones racing are waited for
+    bool any_ready = false;
+    for (const auto &[fd, r] : this->racers)
+    {
+        if (!r.ready && !r.idle)
+            return;
+        any_ready = any_ready || r.ready;
+    }
+    if (!any_ready)
+        return;
+    ++this->round;
+    Generator::generate(RACE_WORDS, this->goal);
+    for (auto &[fd, r] : this->racers)
+    {
+        r.ready = false;
+        this->scores[r.id] = 0;
+    }
+    //? progress of the previous race collected in this wakeup is useless to the racers now
+    this->updates = "G " + std::to_string(this->round) + " " + this->goal + "\n";
+    this->logger << "race " + std::to_string(this->round) + " started with " + std::to_string(this->racers.size()) + " racers";
+}
+
+void RaceServer::serve()
+{
+    epoll_event events[RACE_MAX_EVENTS];
+    std::vector<int> dropped;
+    while (true)
+    {
+        const int ready = epoll_wait(this->epoll_fd, events, RACE_MAX_EVENTS, -1);
+        if (ready < 0 && errno == EINTR)
+            continue;
+        if (ready < 0)
+        {
+            this->logger << std::string("=ERROR= epoll_wait() failed: ") + std::strerror(errno);
+            return;
+        }
+        bool stopping = false;
+        dropped.clear();
+        for (int i = 0; i < ready; ++i)
+        {
+            const int fd = events[i].data.fd;
+            if (fd == this->wake_fd)
+            {
+                stopping = true;
+                continue;
+            }
+            if (fd == this->listen_fd)
+            {
+                this->accept_racers();
+                continue;
+            }
+            auto found = this->racers.find(fd);
+            if (found == this->racers.end())
+                continue;
+            if ((events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) && !this->read_racer(fd, found->second))
+                dropped.push_back(fd);
+            else if ((events[i].events & EPOLLOUT) && !this->flush(fd, found->second))
+                dropped.push_back(fd);
+        }
+        if (stopping)
+            break;
+        for (int fd : dropped)
+            this->drop(fd);
+        this->start_round_if_ready();
+
+        //? everything read during this wakeup goes out with one write per racer, so a burst of progress from hundreds
+        //? of racers costs one syscall per racer instead of one per racer per update
+        dropped.clear();
+        for (auto &[fd, r] : this->racers)
+        {
+            r.output += this->updates;
+            if (!r.output.empty() && !this->flush(fd, r))
+                dropped.push_back(fd);
+        }
+        this->updates.clear();
+        for (int fd : dropped)
+            this->drop(fd);
+    }
+    this->logger << "stopped";
+}
+
+void RaceServer::stop()
+{
+    const uint64_t one = 1;
+    ssize_t written = write(this->wake_fd, &one, sizeof(one));
+    (void)written;
+}
+
+int RaceServer::run(const std::string &socket_path)
+{
+    typer_settings settings;
+    std::vector<std::string> errors;
+    settings.load(DEFAULT_CONFIG_FILENAME, errors);
+    for (const std::string &error : errors)
+        std::cerr << error << std::endl;
+    //? a text mode config names a text, not a word list
+    Generator::init(settings.mode == typer_mode::TEXT ? typer_settings().words_filename : settings.words_filename);
+    RaceServer server(socket_path);
+    std::string error;
+    if (!server.listen(error))
+    {
+        std::cerr << error << std::endl;
+        return EXIT_FAILURE;
+    }
+    running_server = &server;
+    std::signal(SIGINT, handle_stop);
+    std::signal(SIGTERM, handle_stop);
+    std::cout << "race server listening on " << socket_path << ", join with --race " << socket_path << std::endl;
+    server.serve();
+    running_server = nullptr;
+    return EXIT_SUCCESS;
+}
+
+bool RaceClient::connect(const std::string &socket_path, std::string &error)
+{
+    this->close();
+    sockaddr_un address;
+    if (!make_address(socket_path, address))
+    {
+        error = "invalid socket path " + socket_path;
+        return false;
+    }
+    this->fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (this->fd < 0 || ::connect(this->fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0)
+    {
+        error = "unable to connect to " + socket_path + ": " + std::strerror(errno);
+        this->close();
+        return false;
+    }
+    return true;
+}
+
+void RaceClient::close()
+{
+    if (this->fd >= 0)
+        ::close(this->fd);
+    this->fd = -1;
+    this->input.clear();
+    this->scores.clear();
+    this->racer_positions.clear();
+}
+
+bool RaceClient::receive()
+{
+    if (this->fd < 0)
+        return false;
+    char buffer[4096];
+    ssize_t count;
+    while ((count = recv(this->fd, buffer, sizeof(buffer), MSG_DONTWAIT)) > 0)
+        this->input.append(buffer, count);
+    split_lines(this->input, [this](const std::string &message)
+                { this->handle(message); });
+    if (count == 0 || (count < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR))
+    {
+        this->close();
+        return false;
+    }
+    return true;
+}
+
+void RaceClient::handle(const std::string &message)
+{
+    if (message.size() < 3 || message[1] != ' ')
+        return;
+    const char *data = message.c_str() + 2;
+    char *end;
+    switch (message[0])
+    {
+    case 'W':
+        this->id = std::strtoul(data, nullptr, 10);
+        break;
+    case 'G':
+        this->round = std::strtoul(data, &end, 10);
+        if (*end == ' ')
+        {
+            this->goal.assign(end + 1);
+            this->goal_pending = true;
+        }
+        this->scores.clear();
+        this->positions_stale = true;
+        break;
+    case 'P':
+    {
+        const uint32_t id = std::strtoul(data, &end, 10);
+        const uint32_t round = std::strtoul(end, &end, 10);
+        const uint32_t score = std::strtoul(end, nullptr, 10);
+        if (id != this->id && round == this->round)
+        {
+            this->scores[id] = score;
+            this->positions_stale = true;
+        }
+        break;
+    }
+    case 'L':
+        this->scores.erase(std::strtoul(data, nullptr, 10));
+        this->positions_stale = true;
+        break;
+    }
+}
+
+void RaceClient::send(const std::string &message)
+{
+    std::size_t sent = 0;
+    while (this->fd >= 0 && sent < message.size())
+    {
+        ssize_t count = ::send(this->fd, message.data() + sent, message.size() - sent, MSG_NOSIGNAL);
+        if (count < 0 && errno == EINTR)
+            continue;
+        if (count < 0)
+            return; // a lost server shows up in receive()
+        sent += count;
+    }
+}
+
+bool RaceClient::take_goal(std::string &output)
+{
+    if (!this->goal_pending)
+        return false;
+    output.swap(this->goal);
+    this->goal_pending = false;
+    return true;
+}
+
+const std::vector<uint32_t> &RaceClient::positions()
+{
+    if (this->positions_stale)
+    {
+        this->racer_positions.clear();
+        for (const auto &[id, score] : this->scores)
+            this->racer_positions.push_back(score);
+        std::sort(this->racer_positions.begin(), this->racer_positions.end());
+        this->racer_positions.erase(std::unique(this->racer_positions.begin(), this->racer_positions.end()), this->racer_positions.end());
+        this->positions_stale = false;
+    }
+    return this->racer_positions;
+}
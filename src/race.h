@@ -0,0 +1,154 @@
+#pragma once
+
+#include "logger.h"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#define RACE_SOCKET_PATH "/tmp/terminaltyper.sock"
+#define RACE_WORDS 25                    // words of every race goal
+#define RACE_MAX_EVENTS 256              // epoll events handled per wakeup
+#define RACE_MAX_PENDING (4 * 1024 * 1024) // bytes queued for a racer that doesn't read, it's dropped past this
+
+// Protocol, one message per line:
+//   server -> racer   W <id>                      welcome, id of the racer
+//                     G <round> <goal>            goal of a new race (sent on connect too)
+//                     P <id> <round> <score>      progress of a racer (own progress is echoed as well)
+//                     L <id>                      racer left
+//   racer -> server   P <score>                   progress in the current race
+//                     N                           ready for the next race, it starts once every racer is ready
+//                     I                           idle, back in the menu (not waited for until it races again)
+
+/// @brief race server: one goal from a shared Generator corpus raced by every connected client, a single thread
+/// multiplexes the listening socket and all racers with epoll. Progress read during one wakeup is collected and sent
+/// to every racer with one write() per racer
+class RaceServer
+{
+private:
+    struct racer
+    {
+        uint32_t id;
+        std::string input;  // read bytes of an unfinished message
+        std::string output; // bytes the socket didn't take yet
+        bool ready = false;           // asked for the next race
+        bool idle = true;             // not racing (in the menu), the next race doesn't wait for it
+        bool watching_output = false; // EPOLLOUT registered
+    };
+
+    std::string socket_path;
+    int listen_fd = -1;
+    int epoll_fd = -1;
+    int wake_fd = -1; // eventfd, stop() makes it readable
+    std::unordered_map<int, racer> racers; // by socket
+    std::unordered_map<uint32_t, uint32_t> scores; // progress of the current race by racer id
+    uint32_t next_id = 1;
+    uint32_t round = 0;
+    std::string goal;
+    std::string updates; // messages for everyone collected during one wakeup
+    Logger logger;
+
+    /// @brief accept every pending connection and greet the new racers
+    void accept_racers();
+
+    /// @brief read and handle messages of a racer
+    /// @return false if the racer disconnected
+    bool read_racer(int fd, racer &r);
+
+    /// @brief send queued output of a racer, EPOLLOUT is watched while something is left
+    /// @return false if the racer has to be dropped
+    bool flush(int fd, racer &r);
+
+    /// @brief disconnect a racer and tell the others
+    void drop(int fd);
+
+    /// @brief start a new race with a new goal once every racer that isn't idle is ready (and at least one is)
+    void start_round_if_ready();
+
+public:
+    /// @param socket_path path of the Unix socket to listen on
+    explicit RaceServer(std::string socket_path = RACE_SOCKET_PATH);
+    ~RaceServer();
+    RaceServer(const RaceServer &) = delete;
+    RaceServer &operator=(const RaceServer &) = delete;
+
+    /// @brief bind the socket and generate the first goal (the Generator has to be initiated)
+    /// @param error filled with the reason when the server can't start
+    /// @return false if the server can't start
+    bool listen(std::string &error);
+
+    /// @brief serve racers until stop() is called
+    void serve();
+
+    /// @brief make serve() return, may be called from any thread and from a signal handler
+    void stop();
+
+    /// @brief headless entry point, goals come from the word list of the config file, serves until SIGINT or SIGTERM
+    /// @param socket_path path of the Unix socket to listen on
+    /// @return exit code
+    static int run(const std::string &socket_path);
+};
+
+/// @brief connection of the app to a race server, progress of the other racers is kept for drawing their cursors
+class RaceClient
+{
+private:
+    int fd = -1;
+    uint32_t id = 0;
+    uint32_t round = 0;
+    std::string goal;
+    bool goal_pending = false; // goal of a new race not taken yet
+    std::string input;
+    std::unordered_map<uint32_t, uint32_t> scores; // progress of the other racers in the current race by id
+    std::vector<uint32_t> racer_positions;
+    bool positions_stale = false;
+
+    /// @brief handle one message from the server
+    void handle(const std::string &message);
+
+    /// @brief send one message, blocking (messages are a few bytes)
+    void send(const std::string &message);
+
+public:
+    RaceClient() = default;
+    ~RaceClient() { this->close(); }
+    RaceClient(const RaceClient &) = delete;
+    RaceClient &operator=(const RaceClient &) = delete;
+
+    /// @param socket_path path of the server socket
+    /// @param error filled with the reason when the connection fails
+    /// @return true if connected
+    bool connect(const std::string &socket_path, std::string &error);
+
+    void close();
+
+    /// @return true while connected to a server
+    bool connected() const { return this->fd >= 0; }
+
+    /// @return socket to wait on, readable when the server sent something
+    int socket() const { return this->fd; }
+
+    /// @brief read and handle everything the server sent, never blocks
+    /// @return false if the server closed the connection (the client is closed then)
+    bool receive();
+
+    /// @param output replaced with the goal of a new race if one arrived since the last call
+    /// @return true if a new goal was taken
+    bool take_goal(std::string &output);
+
+    /// @param score typed graphemes of the current race goal
+    void send_progress(uint32_t score) { this->send("P " + std::to_string(score) + "\n"); }
+
+    /// @brief ask for the next race
+    void request_next() { this->send("N\n"); }
+
+    /// @brief tell the server this racer went back to the menu, the next race doesn't wait for it then
+    void leave() { this->send("I\n"); }
+
+    /// @return positions of the other racers in the current race, sorted and without duplicates
+    const std::vector<uint32_t> &positions();
+
+    /// @return number of the other racers in the current race
+    std::size_t racers() const { return this->scores.size(); }
+};
@@ -0,0 +1,219 @@
+#include "renderer.h"
+
+#include <algorithm>
+
+void ProgressRenderer::move_to(int row, int col)
+{
+    this->frame += "\033[";
+    this->frame += std::to_string(row);
+    this->frame += ';';
+    this->frame += std::to_string(col);
+    this->frame += 'H';
+}
+
+void ProgressRenderer::invalidate()
+{
+    this->valid = false;
+    this->drawn_stats.clear();
+    this->drawn_marks.clear();
+}
+
+void ProgressRenderer::layout_goal(const std::string &goal, std::string &output)
+{
+    output.assign("\033[");
+    output += std::to_string(TEXT_START_ROW + 1);
+    output += ';';
+    output += std::to_string(TEXT_START_COL + 1);
+    output += 'H';
+    output += INITIAL_COLOR;
+    output += goal;
+    output += RESET;
+}
+
+void ProgressRenderer::draw_layout(const std::string &layout, int terminal_width)
+{
+    this->width = terminal_width <= 0 ? 1 : terminal_width;
+    this->frame += layout;
+    this->valid = true;
+    this->drawn_finished = false;
+    this->drawn_score = 0;
+    this->drawn_marks.clear();
+}
+
+void ProgressRenderer::draw_goal(const std::string &goal, const GraphemeIndex &graphemes, uint32_t score, int terminal_width)
+{
+    if (terminal_width <= 0)
+        terminal_width = 1;
+    if (!this->valid || this->drawn_finished || terminal_width != this->width || score < this->drawn_score)
+    {
+        this->width = terminal_width;
+        this->move_to(TEXT_START_ROW + 1, TEXT_START_COL + 1);
+        this->frame += CORRECT_COLOR;
+        this->frame.append(goal, 0, graphemes.offset(score));
+        this->frame += INITIAL_COLOR;
+        this->frame.append(goal, graphemes.offset(score));
+        this->frame += RESET;
+        this->valid = true;
+        this->drawn_finished = false;
+        this->drawn_marks.clear();
+    }
+    else if (score > this->drawn_score)
+    {
+        const uint32_t column = graphemes.column(this->drawn_score), offset = graphemes.offset(this->drawn_score);
+        this->move_to(this->row_of(column), this->col_of(column));
+        this->frame += CORRECT_COLOR;
+        this->frame.append(goal, offset, graphemes.offset(score) - offset);
+        this->frame += RESET;
+    }
+    this->drawn_score = score;
+}
+
+void ProgressRenderer::draw_finished(const std::string &goal, int terminal_width)
+{
+    this->width = terminal_width <= 0 ? 1 : terminal_width;
+    this->move_to(TEXT_START_ROW + 1, TEXT_START_COL + 1);
+    this->frame += FINISHED_COLOR;
+    this->frame += goal;
+    this->frame += RESET;
+    this->valid = true;
+    this->drawn_finished = true;
+    this->drawn_marks.clear();
+}
+
+void ProgressRenderer::draw_rows(const TextStream &text, uint32_t score, const char *typed_color, const char *initial_color)
+{
+    for (std::size_t row = 0; row < VIEWPORT_ROWS; ++row)
+    {
+        this->move_to(TEXT_START_ROW + 1 + row, TEXT_START_COL + 1);
+        if (row < text.kept_lines())
+        {
+            const text_line &line = text.line(row);
+            const std::string_view characters = text.line_text(row);
+            const std::size_t typed = score <= line.begin ? 0 : text.text_between(line.begin, std::min<uint64_t>(score, line.begin + line.length)).size();
+            this->frame += typed_color;
+            this->frame.append(characters.data(), typed);
+            this->frame += initial_color;
+            this->frame.append(characters.data() + typed, characters.size() - typed);
+            this->frame += RESET;
+        }
+        this->frame += "\033[K";
+    }
+}
+
+void ProgressRenderer::draw_viewport(const TextStream &text, uint32_t score, int terminal_width)
+{
+    if (terminal_width <= 0)
+        terminal_width = 1;
+    if (text.kept_lines() == 0)
+        return;
+    const std::size_t index = text.line_index_of(score);
+    const uint64_t top_line = text.line_number(0), line = text.line_number(index);
+    if (!this->valid || this->drawn_finished || terminal_width != this->width || top_line != this->drawn_top_line ||
+        line != this->drawn_line || score < this->drawn_score)
+    {
+        this->width = terminal_width;
+        this->draw_rows(text, score, CORRECT_COLOR, INITIAL_COLOR);
+        this->valid = true;
+        this->drawn_finished = false;
+    }
+    else if (score > this->drawn_score)
+    {
+        this->move_to(TEXT_START_ROW + 1 + index, TEXT_START_COL + 1 + text.column_in_line(index, this->drawn_score));
+        this->frame += CORRECT_COLOR;
+        this->frame += text.text_between(this->drawn_score, score);
+        this->frame += RESET;
+    }
+    this->drawn_top_line = top_line;
+    this->drawn_line = line;
+    this->drawn_score = score;
+}
+
+void ProgressRenderer::draw_viewport_finished(const TextStream &text, int terminal_width)
+{
+    this->width = terminal_width <= 0 ? 1 : terminal_width;
+    this->draw_rows(text, 0, FINISHED_COLOR, FINISHED_COLOR);
+    this->valid = true;
+    this->drawn_finished = true;
+}
+
+void ProgressRenderer::draw_marks(const std::string &goal, const GraphemeIndex &graphemes, uint32_t score, const std::vector<uint32_t> &positions, const char *color)
+{
+    auto draw = [&](uint32_t index, const char *grapheme_color)
+    {
+        const uint32_t column = graphemes.column(index), offset = graphemes.offset(index);
+        this->move_to(this->row_of(column), this->col_of(column));
+        this->frame += grapheme_color;
+        this->frame.append(goal, offset, graphemes.offset(index + 1) - offset);
+        this->frame += RESET;
+    };
+    const uint32_t size = graphemes.size();
+    const uint32_t typed_from = std::min(this->marks_score, score), typed_to = std::max(this->marks_score, score);
+
+    //? both lists are sorted, one merge pass finds the vacated and the new positions
+    auto drawn = this->drawn_marks.begin();
+    for (uint32_t position : positions)
+    {
+        if (position >= size)
+            break;
+        for (; drawn != this->drawn_marks.end() && *drawn < position; ++drawn)
+            draw(*drawn, *drawn < score ? CORRECT_COLOR : INITIAL_COLOR);
+        const bool kept = drawn != this->drawn_marks.end() && *drawn == position;
+        if (kept)
+            ++drawn;
+        //? typing since the last marks redrew the graphemes between the scores in the typed color
+        if (!kept || (position >= typed_from && position < typed_to))
+            draw(position, color);
+    }
+    for (; drawn != this->drawn_marks.end(); ++drawn)
+        draw(*drawn, *drawn < score ? CORRECT_COLOR : INITIAL_COLOR);
+
+    this->drawn_marks.assign(positions.begin(), std::lower_bound(positions.begin(), positions.end(), size));
+    this->marks_score = score;
+}
+
+void ProgressRenderer::draw_stats(const std::vector<std::string> &lines)
+{
+    this->drawn_stats.resize(lines.size());
+    for (std::size_t i = 0; i < lines.size(); ++i)
+    {
+        const std::string &drawn = this->drawn_stats[i], &line = lines[i];
+        if (drawn == line)
+            continue;
+        std::size_t first = 0, last = line.size();
+        if (drawn.size() == line.size())
+        {
+            while (drawn[first] == line[first])
+                ++first;
+            while (drawn[last - 1] == line[last - 1])
+                --last;
+        }
+        this->move_to(STATS_START_ROW + i, STATS_START_COL + 1 + first);
+        this->frame += STATS_COLOR;
+        this->frame.append(line, first, last - first);
+        this->frame += RESET;
+        this->drawn_stats[i] = line;
+    }
+}
+
+void ProgressRenderer::place_cursor(const GraphemeIndex &graphemes, uint32_t index)
+{
+    this->move_to(this->row_of(graphemes.column(index)), this->col_of(graphemes.column(index)));
+}
+
+void ProgressRenderer::place_cursor(const TextStream &text, uint32_t index)
+{
+    if (text.kept_lines() == 0)
+        return this->move_to(TEXT_START_ROW + 1, TEXT_START_COL + 1);
+    const std::size_t line = text.line_index_of(index);
+    this->move_to(TEXT_START_ROW + 1 + line, TEXT_START_COL + 1 + text.column_in_line(line, index));
+}
+
+void ProgressRenderer::park_cursor(int row)
+{
+    this->move_to(row, 1);
+}
+
+void ProgressRenderer::present()
+{
+    Screen::present();
+}
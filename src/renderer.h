@@ -0,0 +1,133 @@
+#pragma once
+
+#include "terminal.h"
+#include "text_stream.h"
+#include "utf8.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#define TEXT_START_ROW 0
+#define TEXT_START_COL 0
+#define STATS_START_ROW 5
+#define STATS_START_COL 0
+#define STATS_PARK_ROW (STATS_START_ROW + 6)
+#define VIEWPORT_ROWS (STATS_START_ROW - TEXT_START_ROW - 1)
+#define VIEWPORT_ROWS_BEHIND 1
+
+#define INITIAL_COLOR "\033[0m"
+#define CORRECT_COLOR "\033[1;32m"
+#define FINISHED_COLOR "\033[1;34m"
+#define STATS_COLOR "\033[1;36m"
+#define DESCRIPTION_COLOR "\033[1;34m"
+#define OPTION_CONFIG_COLOR "\033[1;3;4;35m"
+#define OPTION_PICKED_COLOR "\033[1;4;6;32m"
+#define RACER_COLOR "\033[7;35m"
+#define GHOST_COLOR "\033[7;33m"
+#define RESET "\033[0m"
+
+/// @brief draws the typing test screen, remembers what is already on the screen and emits only the cells that changed
+/// into the Screen frame, every frame is sent with a single write()
+class ProgressRenderer
+{
+private:
+    std::string &frame = Screen::frame();
+    bool valid = false;
+    int width = 0;
+    uint32_t drawn_score = 0;
+    bool drawn_finished = false;
+    std::vector<std::string> drawn_stats;
+    uint64_t drawn_top_line = 0;
+    uint64_t drawn_line = 0;
+    std::vector<uint32_t> drawn_marks; // goal positions highlighted by draw_marks, empty after a full goal redraw
+    uint32_t marks_score = 0;          // score the marks were drawn at
+
+    /// @brief append cursor movement to the frame
+    /// @param row 1-based terminal row
+    /// @param col 1-based terminal column
+    void move_to(int row, int col);
+
+    /// @brief append the viewport rows, the whole lines are drawn and the rest of every row is cleared
+    /// @param text streamed text
+    /// @param score number of correctly typed graphemes
+    /// @param typed_color color of the typed part
+    /// @param initial_color color of the rest
+    void draw_rows(const TextStream &text, uint32_t score, const char *typed_color, const char *initial_color);
+
+    /// @param column display column of a goal grapheme counted from the goal start
+    /// @return 1-based terminal row of the grapheme
+    int row_of(uint32_t column) const { return TEXT_START_ROW + 1 + column / this->width; }
+
+    /// @param column display column of a goal grapheme counted from the goal start
+    /// @return 1-based terminal column of the grapheme
+    int col_of(uint32_t column) const { return TEXT_START_COL + 1 + column % this->width; }
+
+public:
+    /// @brief forget the screen model, the next frame is drawn from scratch (after clearing the screen or a new goal)
+    void invalidate();
+
+    /// @brief lay out the from-scratch frame of a goal nothing was typed of yet, may be called from any thread
+    /// @param goal test text
+    /// @param output replaced with the frame part drawing the goal (see draw_layout)
+    static void layout_goal(const std::string &goal, std::string &output);
+
+    /// @brief draw goal prepared with layout_goal, the screen model is set as if draw_goal drew it
+    /// @param layout output of layout_goal
+    /// @param terminal_width current terminal width
+    void draw_layout(const std::string &layout, int terminal_width);
+
+    /// @brief draw goal with the already typed part highlighted
+    /// @param goal test text
+    /// @param graphemes grapheme index of the goal
+    /// @param score number of correctly typed graphemes
+    /// @param terminal_width current terminal width, a change redraws the whole goal
+    void draw_goal(const std::string &goal, const GraphemeIndex &graphemes, uint32_t score, int terminal_width);
+
+    /// @brief draw the whole goal in the finished color
+    /// @param goal test text
+    /// @param terminal_width current terminal width
+    void draw_finished(const std::string &goal, int terminal_width);
+
+    /// @brief draw the kept lines of a streamed text (up to VIEWPORT_ROWS) with the already typed part highlighted,
+    /// the rows are redrawn only when the text scrolls, else only the newly typed characters are sent
+    /// @param text streamed text advanced to the score (VIEWPORT_ROWS_BEHIND lines kept above the score line)
+    /// @param score number of correctly typed graphemes
+    /// @param terminal_width current terminal width
+    void draw_viewport(const TextStream &text, uint32_t score, int terminal_width);
+
+    /// @brief draw the kept lines of a streamed text in the finished color
+    /// @param text streamed text
+    /// @param terminal_width current terminal width
+    void draw_viewport_finished(const TextStream &text, int terminal_width);
+
+    /// @brief highlight goal graphemes at given positions (e.g. cursors of other racers or of the ghost) over a goal drawn with
+    /// draw_goal, only marks that moved are redrawn and vacated graphemes get their typed or initial color back
+    /// @param goal test text
+    /// @param graphemes grapheme index of the goal
+    /// @param score number of correctly typed graphemes, as passed to draw_goal
+    /// @param positions grapheme numbers, sorted and without duplicates (positions past the goal are skipped)
+    /// @param color color of the marks
+    void draw_marks(const std::string &goal, const GraphemeIndex &graphemes, uint32_t score, const std::vector<uint32_t> &positions, const char *color);
+
+    /// @brief draw stats box lines starting at STATS_START_ROW, only lines different from the previous frame are sent
+    /// @param lines box lines
+    void draw_stats(const std::vector<std::string> &lines);
+
+    /// @brief put the terminal cursor on given goal grapheme
+    /// @param graphemes grapheme index of the goal
+    /// @param index grapheme number
+    void place_cursor(const GraphemeIndex &graphemes, uint32_t index);
+
+    /// @brief put the terminal cursor on given grapheme of a streamed text
+    /// @param text streamed text drawn with draw_viewport
+    /// @param index position in the text
+    void place_cursor(const TextStream &text, uint32_t index);
+
+    /// @brief put the terminal cursor on given row (below the drawn content)
+    /// @param row 1-based terminal row
+    void park_cursor(int row);
+
+    /// @brief send the frame to the terminal with a single write()
+    void present();
+};
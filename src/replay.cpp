@@ -0,0 +1,175 @@
+#include "replay.h"
+#include "generator.h"
+#include "settings.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+void Replayer::add_test(replay_summary &summary, const TestEngine &engine)
+{
+    summary.score += engine.score();
+    summary.inputs += engine.input_count();
+    summary.time_ms += engine.time_ms();
+}
+
+void Replayer::print(const replay_summary &summary)
+{
+    std::cout << std::fixed << std::setprecision(2)
+              << "keys: " << summary.keys << "\n"
+              << "tests: " << summary.tests << "\n"
+              << "characters: " << summary.score << "/" << summary.inputs << "\n"
+              << "accuracy: " << summary.accuracy() * 100 << "%\n"
+              << "time: " << summary.time_ms / 1000. << "s\n"
+              << "WPM: " << summary.wpm() << "\n"
+              << "engine: " << summary.engine_s * 1000. << "ms, "
+              << std::setprecision(0) << (summary.engine_s == 0. ? 0. : summary.keys / summary.engine_s) << " keys/s" << std::endl;
+}
+
+bool Replayer::load(const std::string &filepath, std::vector<replay_key> &keys, std::string &error)
+{
+    keys.clear();
+    std::ifstream file(filepath);
+    if (!file)
+    {
+        error = "unable to open " + filepath;
+        return false;
+    }
+    std::string line;
+    uint32_t line_number = 0;
+    while (std::getline(file, line))
+    {
+        ++line_number;
+        if (line.empty() || line[0] == '#')
+            continue;
+        char *end;
+        const double ms = std::strtod(line.c_str(), &end);
+        const std::size_t separator = end - line.c_str();
+        char32_t typed;
+        if (end == line.c_str() || ms < 0 || separator + 1 >= line.size() || line[separator] != ' ' ||
+            decode_utf8(line.data() + separator + 1, line.data() + line.size(), typed) == 0)
+        {
+            error = filepath + ":" + std::to_string(line_number) + ": expected \"<milliseconds> <typed character>\"";
+            return false;
+        }
+        keys.push_back({static_cast<uint64_t>(ms * 1000000), typed});
+    }
+    return true;
+}
+
+bool Replayer::save(const std::string &filepath, const KeystrokeRecorder &keystrokes)
+{
+    std::ofstream file(filepath);
+    if (!file)
+        return false;
+    file << std::fixed << std::setprecision(3);
+    std::string typed;
+    for (const keystroke_event &event : keystrokes)
+    {
+        typed.clear();
+        append_utf8(typed, event.typed);
+        file << (event.timestamp_ns - keystrokes.begin()->timestamp_ns) / 1000000. << " " << typed << "\n";
+    }
+    return static_cast<bool>(file);
+}
+
+replay_summary Replayer::replay(TestEngine &engine, const std::vector<replay_key> &keys)
+{
+    replay_summary summary;
+    const auto begin = std::chrono::steady_clock::now();
+    for (const replay_key &key : keys)
+    {
+        if (engine.finished())
+            break;
+        engine.type(key.timestamp_ns, key.typed);
+        ++summary.keys;
+    }
+    summary.engine_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    summary.tests = engine.finished();
+    add_test(summary, engine);
+    return summary;
+}
+
+replay_summary Replayer::simulate(TestEngine &engine, uint64_t keys, float wpm, float error_percent)
+{
+    replay_summary summary;
+    std::mt19937 random(REPLAY_SEED);
+    std::bernoulli_distribution mistake(error_percent / 100.f);
+    const uint64_t interval_ns = 60000000000. / (wpm * 5.f);
+    std::string goal;
+    Generator::seed(REPLAY_SEED);
+    Generator::generate(SIMULATED_WORDS, goal);
+    engine.set_goal(goal);
+
+    const auto begin = std::chrono::steady_clock::now();
+    uint64_t timestamp_ns = 0;
+    for (; summary.keys < keys; ++summary.keys)
+    {
+        if (engine.finished())
+        {
+            ++summary.tests;
+            add_test(summary, engine);
+            Generator::generate(SIMULATED_WORDS, goal);
+            engine.set_goal(goal);
+        }
+        const char32_t expected = engine.expected();
+        timestamp_ns += interval_ns;
+        engine.type(timestamp_ns, mistake(random) ? expected + 1 : expected);
+    }
+    summary.engine_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    summary.tests += engine.finished();
+    add_test(summary, engine);
+    return summary;
+}
+
+int Replayer::run(int argc, char *argv[])
+{
+    const std::string command = argv[1];
+    TestEngine engine;
+    if (command == "--replay" && argc == 4)
+    {
+        std::vector<replay_key> keys;
+        std::string error;
+        if (!Replayer::load(argv[3], keys, error))
+        {
+            std::cerr << error << std::endl;
+            return EXIT_FAILURE;
+        }
+        if (!engine.open_text(argv[2]))
+        {
+            std::cerr << "unable to open " << argv[2] << std::endl;
+            return EXIT_FAILURE;
+        }
+        engine.set_view(REPLAY_VIEW_WIDTH, 0, 1);
+        print(replay(engine, keys));
+        return EXIT_SUCCESS;
+    }
+    if (command == "--simulate" && argc >= 3 && argc <= 5)
+    {
+        const uint64_t keys = std::strtoull(argv[2], nullptr, 10);
+        const float wpm = argc > 3 ? std::strtof(argv[3], nullptr) : SIMULATED_WPM;
+        const float error_percent = argc > 4 ? std::strtof(argv[4], nullptr) : SIMULATED_ERROR_PERCENT;
+        if (keys == 0 || wpm <= 0.f || error_percent < 0.f || error_percent > 100.f)
+        {
+            std::cerr << "expected KEYS > 0, WPM > 0 and ERROR_PERCENT in [0, 100]" << std::endl;
+            return EXIT_FAILURE;
+        }
+        Generator::init(typer_settings().words_filename);
+        if (Generator::size() == 0)
+        {
+            std::cerr << "unable to load " << typer_settings().words_filename << std::endl;
+            return EXIT_FAILURE;
+        }
+        print(simulate(engine, keys, wpm, error_percent));
+        return EXIT_SUCCESS;
+    }
+    std::cerr << "usage: " << argv[0] << "\n"
+              << "       " << argv[0] << " --replay GOAL_FILE KEYS_FILE\n"
+              << "       " << argv[0] << " --simulate KEYS [WPM [ERROR_PERCENT]]\n"
+              << "       " << argv[0] << " --server [SOCKET_PATH]\n"
+              << "       " << argv[0] << " --race [SOCKET_PATH]" << std::endl;
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "test_engine.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#define LAST_TEST_KEYS_PATH "logs/last_test.keys"
+#define LAST_TEST_GOAL_PATH "logs/last_test.goal"
+
+#define REPLAY_VIEW_WIDTH 80        // streamed texts are wrapped as in a terminal of this width
+#define REPLAY_SEED 1               // simulations generate the same goals and mistakes every run
+#define SIMULATED_WORDS 50          // words of every generated goal
+#define SIMULATED_WPM 80.f          // default speed of the simulated typist
+#define SIMULATED_ERROR_PERCENT 3.f // default share of wrong keys of the simulated typist
+
+/// @brief one key of a keystroke stream
+struct replay_key
+{
+    uint64_t timestamp_ns;
+    char32_t typed;
+};
+
+/// @brief outcome of a replay, tests of a simulation are summed up
+struct replay_summary
+{
+    uint64_t keys = 0;     // keys fed to the engine
+    uint32_t tests = 0;    // finished goals
+    uint32_t score = 0;    // correctly typed graphemes
+    uint32_t inputs = 0;   // typed graphemes, correct or not
+    int64_t time_ms = 0;   // typing time (first to last key of every test)
+    double engine_s = 0.; // wall time the engine took to process the keys
+
+    /// @return accuracy over all tests
+    float accuracy() const { return this->inputs == 0 ? 0.f : (float)this->score / this->inputs; }
+
+    /// @return WPM over all tests
+    float wpm() const { return this->time_ms == 0 ? 0.f : (this->score / 5.f) / (this->time_ms / 60000.f); }
+};
+
+/// @brief headless test runs: recorded or synthetic keystroke streams with timestamps are typed into a TestEngine
+/// without a terminal, for regression testing of the scoring and profiling of the engine
+class Replayer
+{
+private:
+    /// @brief add results of the engine's test to the summary
+    static void add_test(replay_summary &summary, const TestEngine &engine);
+
+    /// @brief print summary as "name: value" lines
+    static void print(const replay_summary &summary);
+
+public:
+    Replayer() = delete;
+
+    /// @brief read keystroke stream, every line is "<milliseconds> <typed character>" (empty lines and lines starting with # are skipped)
+    /// @param filepath path to the stream
+    /// @param keys replaced with the read keys
+    /// @param error filled with the reason when the stream can't be read
+    /// @return true if the stream was read
+    static bool load(const std::string &filepath, std::vector<replay_key> &keys, std::string &error);
+
+    /// @brief write keystrokes of a test as a stream load() reads, timestamps are relative to the first key
+    /// @param filepath path to the stream
+    /// @param keystrokes recorded keystrokes
+    /// @return false if the file can't be written
+    static bool save(const std::string &filepath, const KeystrokeRecorder &keystrokes);
+
+    /// @brief type keys into the engine's goal until it's finished
+    /// @param engine engine with the goal set
+    /// @param keys keystroke stream
+    /// @return results of the test
+    static replay_summary replay(TestEngine &engine, const std::vector<replay_key> &keys);
+
+    /// @brief type given amount of keys generated on the fly into generated goals, a new goal follows every finished one
+    /// @param engine engine the goals are typed into
+    /// @param keys number of keys
+    /// @param wpm typing speed of the simulated typist
+    /// @param error_percent share of wrong keys
+    /// @return results summed up over the tests
+    static replay_summary simulate(TestEngine &engine, uint64_t keys, float wpm, float error_percent);
+
+    /// @brief headless entry point: "--replay GOAL_FILE KEYS_FILE" or "--simulate KEYS [WPM [ERROR_PERCENT]]"
+    /// @return exit code
+    static int run(int argc, char *argv[]);
+};
@@ -0,0 +1,147 @@
+#include "results_store.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static_assert(sizeof(result_record) == 32, "result_record must stay fixed width");
+
+ResultsView::ResultsView(const std::string &path)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return;
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) < 0 || static_cast<std::size_t>(file_stat.st_size) < sizeof(results_store_header))
+    {
+        close(fd);
+        return;
+    }
+    this->length = file_stat.st_size;
+    void *mapped_file = mmap(nullptr, this->length, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapped_file == MAP_FAILED)
+        return;
+    this->mapped = mapped_file;
+
+    results_store_header header;
+    std::memcpy(&header, this->mapped, sizeof(header));
+    if (std::memcmp(header.magic, RESULTS_STORE_MAGIC, sizeof(header.magic)) != 0 || header.version != RESULTS_STORE_VERSION ||
+        header.record_size != sizeof(result_record))
+        return;
+    this->records = reinterpret_cast<const result_record *>(static_cast<const char *>(this->mapped) + sizeof(header));
+    this->count = (this->length - sizeof(header)) / sizeof(result_record);
+}
+
+ResultsView::~ResultsView()
+{
+    if (this->mapped)
+        munmap(this->mapped, this->length);
+}
+
+ResultsStore::ResultsStore(std::string path) : path(std::move(path)) {}
+
+ResultsStore::~ResultsStore()
+{
+    if (this->fd >= 0)
+        close(this->fd);
+}
+
+uint32_t ResultsStore::corpus_id(const std::string &filename)
+{
+    uint32_t hash = 2166136261u;
+    for (unsigned char c : filename)
+    {
+        hash ^= c;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+bool ResultsStore::prepare()
+{
+    struct stat file_stat;
+    if (fstat(this->fd, &file_stat) < 0)
+        return false;
+    const std::size_t size = file_stat.st_size;
+    if (size == 0)
+    {
+        results_store_header header = {{0}, RESULTS_STORE_VERSION, sizeof(result_record), 0};
+        std::memcpy(header.magic, RESULTS_STORE_MAGIC, sizeof(header.magic));
+        return write(this->fd, &header, sizeof(header)) == sizeof(header);
+    }
+
+    //? records are never appended to a file the app can't read back, it's left as it is for the user to look at
+    results_store_header header;
+    if (size < sizeof(header) || pread(this->fd, &header, sizeof(header), 0) != sizeof(header) ||
+        std::memcmp(header.magic, RESULTS_STORE_MAGIC, sizeof(header.magic)) != 0 || header.version != RESULTS_STORE_VERSION ||
+        header.record_size != sizeof(result_record))
+        return false;
+    if ((size - sizeof(header)) % sizeof(result_record) != 0)
+    {
+        // drop the torn record of an interrupted append so the following ones stay aligned
+        if (ftruncate(this->fd, size - (size - sizeof(header)) % sizeof(result_record)) < 0)
+            return false;
+    }
+    return true;
+}
+
+bool ResultsStore::append(const result_record &record)
+{
+    if (this->fd < 0)
+    {
+        std::error_code ec;
+        const std::filesystem::path directory = std::filesystem::path(this->path).parent_path();
+        if (!directory.empty())
+            std::filesystem::create_directories(directory, ec);
+        this->fd = open(this->path.c_str(), O_RDWR | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+        if (this->fd < 0)
+            return false;
+
+        if (!this->prepare())
+        {
+            close(this->fd);
+            this->fd = -1;
+            return false;
+        }
+    }
+    return write(this->fd, &record, sizeof(record)) == sizeof(record);
+}
+
+results_summary ResultsStore::query(uint32_t last_n, std::optional<uint32_t> corpus_id) const
+{
+    results_summary summary;
+    ResultsView view(this->path);
+    std::vector<float> wpms;
+    for (const result_record *record = view.end(); record != view.begin() && (last_n == 0 || summary.count < last_n);)
+    {
+        --record;
+        if (corpus_id && record->corpus_id != *corpus_id)
+            continue;
+        ++summary.count;
+        summary.best_wpm = std::max(summary.best_wpm, record->wpm);
+        summary.best_accuracy = std::max(summary.best_accuracy, record->accuracy);
+        summary.average_wpm += record->wpm;
+        summary.average_accuracy += record->accuracy;
+        wpms.push_back(record->wpm);
+    }
+    if (summary.count == 0)
+        return summary;
+
+    summary.average_wpm /= summary.count;
+    summary.average_accuracy /= summary.count;
+    auto percentile = [&wpms](float fraction)
+    {
+        auto nth = wpms.begin() + static_cast<std::size_t>(fraction * (wpms.size() - 1));
+        std::nth_element(wpms.begin(), nth, wpms.end());
+        return *nth;
+    };
+    summary.median_wpm = percentile(0.5f);
+    summary.p90_wpm = percentile(0.9f);
+    return summary;
+}
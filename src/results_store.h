@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#define RESULTS_STORE_PATH "logs/results.db"
+#define RESULTS_STORE_MAGIC "TTRS"
+#define RESULTS_STORE_VERSION 1
+#define RESULT_FLAG_INTERRUPTED 1u // the test was left with ESC before its goal or time limit was reached
+
+struct results_store_header
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t record_size;
+    uint32_t reserved;
+};
+
+/// @brief one finished test, fixed width so the n-th record is at header + n * sizeof(result_record)
+struct result_record
+{
+    int64_t timestamp;  // seconds since epoch
+    uint32_t corpus_id; // ResultsStore::corpus_id of the words/text file
+    uint16_t word_count;
+    uint8_t mode; // typer_mode
+    uint8_t flags; // RESULT_FLAG_*
+    float accuracy; // 0..1
+    float time_s;
+    float wpm;
+    uint32_t timeline; // 1 + offset of the typing timeline in the timelines file (see TimelineStore), 0 for none
+};
+
+struct results_summary
+{
+    uint32_t count = 0;
+    float best_wpm = 0.f;
+    float average_wpm = 0.f;
+    float median_wpm = 0.f;
+    float p90_wpm = 0.f;
+    float best_accuracy = 0.f;
+    float average_accuracy = 0.f;
+};
+
+/// @brief read-only mapping of the results file
+class ResultsView
+{
+private:
+    void *mapped = nullptr;
+    std::size_t length = 0;
+    const result_record *records = nullptr;
+    std::size_t count = 0;
+
+public:
+    /// @param path results file, the view is empty if it doesn't exist or isn't a results file
+    explicit ResultsView(const std::string &path);
+    ~ResultsView();
+    ResultsView(const ResultsView &) = delete;
+    ResultsView &operator=(const ResultsView &) = delete;
+
+    std::size_t size() const { return this->count; }
+    const result_record *begin() const { return this->records; }
+    const result_record *end() const { return this->records + this->count; }
+};
+
+/// @brief append-only file of fixed width result records with queries over the latest results
+class ResultsStore
+{
+private:
+    std::string path;
+    int fd = -1;
+
+    /// @brief write the header to a new file, validate the header of an existing one and drop its torn record
+    /// @return false if the file can't be appended to
+    bool prepare();
+
+public:
+    /// @param path results file, created with its directory on the first append
+    explicit ResultsStore(std::string path = RESULTS_STORE_PATH);
+    ~ResultsStore();
+    ResultsStore(const ResultsStore &) = delete;
+    ResultsStore &operator=(const ResultsStore &) = delete;
+
+    /// @param filename words/text file the test was generated from
+    /// @return stable id of the file (FNV-1a hash of the name)
+    static uint32_t corpus_id(const std::string &filename);
+
+    /// @brief append one record to the file
+    /// @return false if the record couldn't be written or the existing file isn't a results file of this version
+    bool append(const result_record &record);
+
+    /// @brief best, average and percentile values over the latest results
+    /// @param last_n how many of the latest matching results are taken into account (0 for all)
+    /// @param corpus_id only results of this corpus are taken into account if given
+    results_summary query(uint32_t last_n, std::optional<uint32_t> corpus_id = std::nullopt) const;
+
+    /// @return path of the results file
+    const std::string &filepath() const { return this->path; }
+};
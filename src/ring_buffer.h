@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/// @brief bounded lock-free multi-producer multi-consumer queue (every slot carries a sequence number telling whose turn it is)
+/// @tparam T stored element
+/// @tparam Capacity number of slots, must be a power of two
+template <typename T, std::size_t Capacity>
+class RingBuffer
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "RingBuffer capacity must be a power of two");
+
+private:
+    struct slot
+    {
+        std::atomic<std::size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<slot[]> slots;
+    alignas(64) std::atomic<std::size_t> head{0};
+    alignas(64) std::atomic<std::size_t> tail{0};
+
+public:
+    RingBuffer() : slots(new slot[Capacity])
+    {
+        for (std::size_t i = 0; i < Capacity; ++i)
+            this->slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    RingBuffer(const RingBuffer &) = delete;
+    RingBuffer &operator=(const RingBuffer &) = delete;
+
+    /// @brief move value into the queue
+    /// @param value element to be stored, left untouched if the queue is full
+    /// @return false if the queue is full
+    bool try_push(T &value)
+    {
+        std::size_t position = this->tail.load(std::memory_order_relaxed);
+        while (true)
+        {
+            slot &current = this->slots[position & (Capacity - 1)];
+            std::size_t sequence = current.sequence.load(std::memory_order_acquire);
+            std::intptr_t difference = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+            if (difference == 0)
+            {
+                if (this->tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    current.value = std::move(value);
+                    current.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (difference < 0)
+                return false;
+            else
+                position = this->tail.load(std::memory_order_relaxed);
+        }
+    }
+
+    /// @brief move the oldest element out of the queue
+    /// @param value receives the element
+    /// @return false if the queue is empty
+    bool try_pop(T &value)
+    {
+        std::size_t position = this->head.load(std::memory_order_relaxed);
+        while (true)
+        {
+            slot &current = this->slots[position & (Capacity - 1)];
+            std::size_t sequence = current.sequence.load(std::memory_order_acquire);
+            std::intptr_t difference = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position + 1);
+            if (difference == 0)
+            {
+                if (this->head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    value = std::move(current.value);
+                    current.sequence.store(position + Capacity, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (difference < 0)
+                return false;
+            else
+                position = this->head.load(std::memory_order_relaxed);
+        }
+    }
+};
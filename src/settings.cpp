@@ -0,0 +1,141 @@
+#include "settings.h"
+
+#include <fstream>
+#include <stdexcept>
+
+namespace
+{
+    bool parse_bool(const std::string &value, bool &result, std::string &error)
+    {
+        if (value != "0" && value != "1")
+        {
+            error = "expected 0 or 1, got \"" + value + "\"";
+            return false;
+        }
+        result = value == "1";
+        return true;
+    }
+
+    bool parse_uint(const std::string &value, uint32_t min, uint32_t max, uint32_t &result, std::string &error)
+    {
+        std::size_t parsed = 0;
+        unsigned long number = 0;
+        try
+        {
+            number = std::stoul(value, &parsed);
+        }
+        catch (const std::exception &e)
+        {
+            parsed = 0;
+        }
+        if (value.empty() || parsed != value.size() || value[0] == '-' || number < min || number > max)
+        {
+            error = "expected number from " + std::to_string(min) + " to " + std::to_string(max) + ", got \"" + value + "\"";
+            return false;
+        }
+        result = number;
+        return true;
+    }
+}
+
+const std::vector<std::string> &typer_settings::names()
+{
+    static const std::vector<std::string> setting_names = {"adaptive", "ghost", "mode", "no_words", "seed", "show_stats", "time_limit", "trailing_cursor", "words_filename"};
+    return setting_names;
+}
+
+bool typer_settings::set(const std::string &name, const std::string &value, std::string &error)
+{
+    if (name == "mode")
+    {
+        if (value != CLASSIC_MODE && value != TEXT_MODE && value != TIMED_MODE)
+        {
+            error = "unknown mode \"" + value + "\"";
+            return false;
+        }
+        this->mode = value == CLASSIC_MODE ? typer_mode::CLASSIC : value == TEXT_MODE ? typer_mode::TEXT
+                                                                                       : typer_mode::TIMED;
+        return true;
+    }
+    if (name == "no_words")
+        return parse_uint(value, MIN_WORDS_AMOUNT, MAX_WORDS_AMOUNT, this->no_words, error);
+    if (name == "time_limit")
+        return parse_uint(value, MIN_TIME_LIMIT, MAX_TIME_LIMIT, this->time_limit, error);
+    if (name == "words_filename")
+    {
+        if (value.empty())
+        {
+            error = "filename can't be empty";
+            return false;
+        }
+        this->words_filename = value;
+        return true;
+    }
+    if (name == "trailing_cursor")
+        return parse_bool(value, this->trailing_cursor, error);
+    if (name == "show_stats")
+        return parse_bool(value, this->show_stats, error);
+    if (name == "adaptive")
+        return parse_bool(value, this->adaptive, error);
+    if (name == "ghost")
+        return parse_bool(value, this->ghost, error);
+    if (name == "seed")
+    {
+        uint32_t seed_value;
+        if (value.empty())
+            this->seed.reset();
+        else if (parse_uint(value, 0, UINT32_MAX, seed_value, error))
+            this->seed = seed_value;
+        else
+            return false;
+        return true;
+    }
+    error = "unknown setting \"" + name + "\"";
+    return false;
+}
+
+bool typer_settings::load(const std::string &filename, std::vector<std::string> &errors)
+{
+    std::ifstream infile(filename);
+    if (!infile.is_open())
+        return false;
+    std::string line, error;
+    uint32_t line_number = 0;
+    while (std::getline(infile, line))
+    {
+        ++line_number;
+        if (line.empty())
+            continue;
+        std::size_t pos = line.find('=');
+        if (pos == std::string::npos)
+            error = "expected name=value";
+        else if (this->set(line.substr(0, pos), line.substr(pos + 1), error))
+            continue;
+        errors.push_back(filename + ":" + std::to_string(line_number) + ": " + error);
+    }
+    return true;
+}
+
+std::string typer_settings::get(const std::string &name) const
+{
+    if (name == "mode")
+        return this->mode == typer_mode::CLASSIC ? CLASSIC_MODE : this->mode == typer_mode::TEXT ? TEXT_MODE
+                                                                                                 : TIMED_MODE;
+    if (name == "no_words")
+        return std::to_string(this->no_words);
+    if (name == "time_limit")
+        return std::to_string(this->time_limit);
+    if (name == "words_filename")
+        return this->words_filename;
+    if (name == "trailing_cursor")
+        return this->trailing_cursor ? "1" : "0";
+    if (name == "show_stats")
+        return this->show_stats ? "1" : "0";
+    if (name == "adaptive")
+        return this->adaptive ? "1" : "0";
+    if (name == "ghost")
+        return this->ghost ? "1" : "0";
+    if (name == "seed")
+        return this->seed ? std::to_string(*this->seed) : "";
+    return "";
+}
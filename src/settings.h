@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#define DEFAULT_CONFIG_FILENAME "config.txt"
+
+#define CLASSIC_MODE "0"
+#define TEXT_MODE "1"
+#define TIMED_MODE "2"
+
+#define MIN_WORDS_AMOUNT 1
+#define MAX_WORDS_AMOUNT 1000
+
+#define MIN_TIME_LIMIT 1
+#define MAX_TIME_LIMIT 3600
+
+// time limits (seconds) offered in the menu
+inline constexpr uint32_t TIME_LIMITS[] = {15, 30, 60, 120};
+
+enum class typer_mode : uint8_t
+{
+    CLASSIC = 0,
+    TEXT = 1,
+    TIMED = 2 // generated words until the time limit
+};
+
+/// @brief app settings parsed once from the config file, read as plain fields everywhere else
+struct typer_settings
+{
+    typer_mode mode = typer_mode::CLASSIC;
+    uint32_t no_words = 10;
+    uint32_t time_limit = 30; // seconds of a timed test
+    std::string words_filename = "words/words.txt";
+    bool trailing_cursor = true;
+    bool show_stats = true;
+    bool adaptive = false;
+    bool ghost = false; // race the fastest previous run of the same goal
+    std::optional<uint32_t> seed;
+
+    /// @return names of all settings in the order they are saved to the config file
+    static const std::vector<std::string> &names();
+
+    /// @brief parse and validate setting value, invalid values leave the setting untouched
+    /// @param name setting name as in the config file
+    /// @param value value as in the config file
+    /// @param error filled with the reason when the value is rejected
+    /// @return true if the setting was changed
+    bool set(const std::string &name, const std::string &value, std::string &error);
+
+    /// @brief parse config file, one name=value per line, invalid lines leave their setting untouched
+    /// @param filename config file
+    /// @param errors filled with the reason (prefixed with file:line) of every rejected line
+    /// @return false if the file can't be opened
+    bool load(const std::string &filename, std::vector<std::string> &errors);
+
+    /// @param name setting name as in the config file
+    /// @return value as written to the config file, "" for unset optional settings
+    std::string get(const std::string &name) const;
+};
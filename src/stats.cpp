@@ -0,0 +1,143 @@
+#include "stats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+StatsAggregator::StatsAggregator(std::string path) : path(std::move(path))
+{
+    this->reset();
+}
+
+void StatsAggregator::reset()
+{
+    this->aggregate = {};
+    std::memcpy(this->aggregate.magic, STATS_MAGIC, sizeof(this->aggregate.magic));
+    this->aggregate.version = STATS_VERSION;
+}
+
+void StatsAggregator::load(const ResultsStore &store)
+{
+    std::ifstream file(this->path, std::ios::binary);
+    stats_aggregate saved;
+    if (file.read(reinterpret_cast<char *>(&saved), sizeof(saved)) &&
+        std::memcmp(saved.magic, STATS_MAGIC, sizeof(saved.magic)) == 0 && saved.version == STATS_VERSION)
+        this->aggregate = saved;
+    else
+        this->reset();
+
+    //? the aggregates are rebuilt when the results file was replaced, its first and last applied records don't match then
+    ResultsView view(store.filepath());
+    const uint64_t applied = this->aggregate.results_applied;
+    if (applied > view.size() ||
+        (applied != 0 && (view.begin()->timestamp != this->aggregate.first_timestamp ||
+                          view.begin()[applied - 1].timestamp != this->aggregate.last_timestamp)))
+        this->reset();
+    if (this->aggregate.results_applied == view.size())
+        return;
+    for (const result_record *record = view.begin() + this->aggregate.results_applied; record != view.end(); ++record)
+        this->add(*record);
+    this->save();
+}
+
+void StatsAggregator::add(const result_record &record)
+{
+    stats_aggregate &a = this->aggregate;
+    if (a.results_applied++ == 0)
+        a.first_timestamp = record.timestamp;
+    a.last_timestamp = record.timestamp;
+    //? the WPM of an interrupted test comes from the few graphemes typed, it would skew the averages and the bests
+    if (record.flags & RESULT_FLAG_INTERRUPTED)
+        return;
+    ++a.tests;
+    a.wpm_sum += record.wpm;
+    a.accuracy_sum += record.accuracy;
+    a.recent_wpm[a.recent_head] = record.wpm;
+    a.recent_accuracy[a.recent_head] = record.accuracy;
+    a.recent_head = (a.recent_head + 1) % STATS_RECENT;
+    a.recent_count = std::min<uint32_t>(a.recent_count + 1, STATS_RECENT);
+
+    personal_best *best = &a.text_best;
+    if (record.mode == static_cast<uint8_t>(typer_mode::CLASSIC))
+    {
+        const bool in_menu = record.word_count % STATS_WORD_STEP == 0 && record.word_count / STATS_WORD_STEP >= 1 &&
+                             record.word_count / STATS_WORD_STEP <= STATS_WORD_SLOTS;
+        best = in_menu ? &a.classic_best[record.word_count / STATS_WORD_STEP - 1] : &a.classic_other_best;
+    }
+    else if (record.mode == static_cast<uint8_t>(typer_mode::TIMED))
+    {
+        //? only tests typed until the end of one of the menu's limits count (results saved before the interrupted
+        //? flag existed are told apart by their time)
+        best = nullptr;
+        for (uint32_t i = 0; i < STATS_TIME_SLOTS; ++i)
+            if (std::abs(record.time_s - TIME_LIMITS[i]) < 0.001f)
+                best = &a.timed_best[i];
+        if (!best)
+            return;
+    }
+    if (record.wpm > best->wpm)
+        *best = {record.wpm, record.accuracy, record.timestamp};
+}
+
+bool StatsAggregator::save() const
+{
+    std::error_code ec;
+    const std::filesystem::path directory = std::filesystem::path(this->path).parent_path();
+    if (!directory.empty())
+        std::filesystem::create_directories(directory, ec);
+    std::ofstream file(this->path, std::ios::binary | std::ios::trunc);
+    return file && file.write(reinterpret_cast<const char *>(&this->aggregate), sizeof(this->aggregate));
+}
+
+float StatsAggregator::rolling_wpm() const
+{
+    float sum = 0.f;
+    for (uint32_t i = 0; i < this->aggregate.recent_count; ++i)
+        sum += this->recent_wpm(i);
+    return this->aggregate.recent_count == 0 ? 0.f : sum / this->aggregate.recent_count;
+}
+
+float StatsAggregator::rolling_accuracy() const
+{
+    float sum = 0.f;
+    for (uint32_t i = 0; i < this->aggregate.recent_count; ++i)
+        sum += this->recent_accuracy(i);
+    return this->aggregate.recent_count == 0 ? 0.f : sum / this->aggregate.recent_count;
+}
+
+float StatsAggregator::accuracy_trend() const
+{
+    const uint32_t count = this->aggregate.recent_count, half = count / 2;
+    if (half == 0)
+        return 0.f;
+    float older = 0.f, newer = 0.f;
+    for (uint32_t i = 0; i < half; ++i)
+    {
+        older += this->recent_accuracy(i);
+        newer += this->recent_accuracy(count - 1 - i);
+    }
+    return (newer - older) / half;
+}
+
+std::string StatsAggregator::sparkline() const
+{
+    static const char *const bars[] = {"▁", "▂", "▃", "▄", "▅", "▆", "▇", "█"};
+    const uint32_t count = this->aggregate.recent_count;
+    if (count == 0)
+        return std::string();
+    float low = this->recent_wpm(0), high = low;
+    for (uint32_t i = 1; i < count; ++i)
+    {
+        low = std::min(low, this->recent_wpm(i));
+        high = std::max(high, this->recent_wpm(i));
+    }
+    std::string line;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const int level = high == low ? 3 : static_cast<int>((this->recent_wpm(i) - low) / (high - low) * 7.f + 0.5f);
+        line += bars[level];
+    }
+    return line;
+}
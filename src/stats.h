@@ -0,0 +1,95 @@
+#pragma once
+
+#include "results_store.h"
+#include "settings.h"
+
+#include <cstdint>
+#include <string>
+
+#define STATS_PATH "logs/stats.bin"
+#define STATS_MAGIC "TTST"
+#define STATS_VERSION 3
+#define STATS_RECENT 20       // tests the rolling average, accuracy trend and sparkline are computed over
+#define STATS_WORD_SLOTS 10   // classic mode personal bests for 5, 10, .., 50 words
+#define STATS_WORD_STEP 5
+#define STATS_TIME_SLOTS 4    // timed mode personal bests for the limits in TIME_LIMITS
+
+static_assert(sizeof(TIME_LIMITS) / sizeof(TIME_LIMITS[0]) == STATS_TIME_SLOTS, "a personal best slot for every time limit");
+
+struct personal_best
+{
+    float wpm;
+    float accuracy;
+    int64_t timestamp;
+};
+
+/// @brief history aggregates updated with every finished test, fixed size so loading and reading them is O(1)
+struct stats_aggregate
+{
+    char magic[4];
+    uint32_t version;
+    uint64_t results_applied; // records of the results store already folded in
+    int64_t first_timestamp;  // timestamp of the first applied record, identifies the results store with the next one
+    int64_t last_timestamp;   // timestamp of the last applied record
+    uint64_t tests;
+    double wpm_sum;
+    double accuracy_sum;
+    float recent_wpm[STATS_RECENT]; // ring buffer, recent_head is the slot of the next result
+    float recent_accuracy[STATS_RECENT];
+    uint32_t recent_head;
+    uint32_t recent_count;
+    personal_best classic_best[STATS_WORD_SLOTS];
+    personal_best classic_other_best; // word counts not offered in the menu
+    personal_best timed_best[STATS_TIME_SLOTS];
+    personal_best text_best;
+};
+
+class StatsAggregator
+{
+private:
+    std::string path;
+    stats_aggregate aggregate;
+
+    /// @brief start from empty aggregates
+    void reset();
+
+public:
+    /// @param path file the aggregates are kept in
+    explicit StatsAggregator(std::string path = STATS_PATH);
+
+    /// @brief load saved aggregates and fold in results the aggregates don't know about yet
+    /// (only the missing tail of the results store is read, all of it only if the aggregates file is missing or was
+    /// built from another results file)
+    /// @param store results store the aggregates are kept in sync with
+    void load(const ResultsStore &store);
+
+    /// @brief fold one finished test into the aggregates, interrupted tests are only marked as applied
+    /// @param record result of the test
+    void add(const result_record &record);
+
+    /// @brief write aggregates to the file
+    /// @return false if the file couldn't be written
+    bool save() const;
+
+    const stats_aggregate &get() const { return this->aggregate; }
+
+    /// @return average WPM of the recent tests
+    float rolling_wpm() const;
+
+    /// @return average accuracy of the recent tests
+    float rolling_accuracy() const;
+
+    /// @return change of average accuracy between the older and the newer half of the recent tests
+    float accuracy_trend() const;
+
+    /// @return recent WPM as a sparkline, oldest test first
+    std::string sparkline() const;
+
+    /// @param i 0 for the oldest recent test
+    /// @return WPM of the i-th recent test
+    float recent_wpm(uint32_t i) const { return this->aggregate.recent_wpm[(this->aggregate.recent_head + STATS_RECENT - this->aggregate.recent_count + i) % STATS_RECENT]; }
+
+    /// @param i 0 for the oldest recent test
+    /// @return accuracy of the i-th recent test
+    float recent_accuracy(uint32_t i) const { return this->aggregate.recent_accuracy[(this->aggregate.recent_head + STATS_RECENT - this->aggregate.recent_count + i) % STATS_RECENT]; }
+};
@@ -0,0 +1,359 @@
+#include "terminal.h"
+
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+terminal_size TerminalGeometry::cached = {DEFAULT_TERMINAL_WIDTH, DEFAULT_TERMINAL_HEIGHT};
+volatile sig_atomic_t TerminalGeometry::resized = 0;
+int TerminalGeometry::pipe_fds[2] = {-1, -1};
+bool TerminalGeometry::installed = false;
+std::streambuf *Screen::previous = nullptr;
+struct termios TerminalSession::original;
+volatile bool TerminalSession::active = false;
+
+namespace
+{
+    const int restored_signals[] = {SIGINT, SIGTERM, SIGHUP, SIGQUIT, SIGSEGV, SIGABRT, SIGBUS, SIGFPE};
+
+    char input_buffer[INPUT_BUFFER_SIZE];
+    std::size_t input_begin = 0, input_end = 0;
+    uint64_t input_timestamp_ns = 0; // time the buffered input was read at
+    KeyDecoder decoder;
+
+    /// @param timeout_ms maximum waiting time
+    /// @return true if stdin became readable in time
+    bool wait_for_input(int timeout_ms)
+    {
+        struct pollfd stdin_poll = {STDIN_FILENO, POLLIN, 0};
+        int ready;
+        do
+            ready = poll(&stdin_poll, 1, timeout_ms);
+        while (ready < 0 && errno == EINTR);
+        return ready > 0;
+    }
+
+    /// @brief read available input into the (empty) buffer and timestamp it
+    /// @return false if stdin is closed
+    bool read_input()
+    {
+        ssize_t count;
+        do
+            count = read(STDIN_FILENO, input_buffer, INPUT_BUFFER_SIZE);
+        while (count < 0 && errno == EINTR);
+        input_timestamp_ns = now_ns();
+        if (count <= 0)
+        {
+            if (count < 0)
+                perror("read()");
+            return false;
+        }
+        input_begin = 0;
+        input_end = count;
+        return true;
+    }
+
+    /// @brief feed buffered bytes to the decoder until a key is decoded or the buffer is empty
+    void decode_input()
+    {
+        while (input_begin != input_end && !decoder.ready())
+            decoder.feed(input_buffer[input_begin++]);
+    }
+}
+
+uint64_t now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void TerminalGeometry::handle_resize(int)
+{
+    const int saved_errno = errno;
+    resized = 1;
+    const char byte = 0;
+    ssize_t written = write(pipe_fds[1], &byte, 1);
+    (void)written;
+    errno = saved_errno;
+}
+
+void TerminalGeometry::install()
+{
+    if (pipe(pipe_fds) == 0)
+    {
+        for (int fd : pipe_fds)
+        {
+            fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+            fcntl(fd, F_SETFD, FD_CLOEXEC);
+        }
+    }
+    else
+        perror("pipe()");
+
+    struct sigaction action = {};
+    action.sa_handler = TerminalGeometry::handle_resize;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    sigaction(SIGWINCH, &action, nullptr);
+    installed = true;
+}
+
+void TerminalGeometry::query()
+{
+    struct winsize size;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0 && size.ws_col > 0 && size.ws_row > 0)
+        cached = {size.ws_col, size.ws_row};
+}
+
+terminal_size TerminalGeometry::size()
+{
+    if (!installed)
+    {
+        install();
+        query();
+    }
+    else if (resized)
+    {
+        resized = 0;
+        char drain[64];
+        while (read(pipe_fds[0], drain, sizeof(drain)) > 0)
+            ;
+        query();
+    }
+    return cached;
+}
+
+int TerminalGeometry::fd()
+{
+    if (!installed)
+        size();
+    return pipe_fds[0];
+}
+
+FrameBuffer::int_type FrameBuffer::overflow(int_type ch)
+{
+    if (!traits_type::eq_int_type(ch, traits_type::eof()))
+        this->data += traits_type::to_char_type(ch);
+    return traits_type::not_eof(ch);
+}
+
+std::streamsize FrameBuffer::xsputn(const char *s, std::streamsize count)
+{
+    this->data.append(s, count);
+    return count;
+}
+
+void FrameBuffer::present()
+{
+    const char *data = this->data.data();
+    std::size_t left = this->data.size();
+    while (left > 0)
+    {
+        ssize_t count = write(STDOUT_FILENO, data, left);
+        if (count < 0 && errno == EINTR)
+            continue;
+        if (count < 0)
+            break;
+        data += count;
+        left -= count;
+    }
+    this->data.clear();
+}
+
+FrameBuffer &Screen::buffer()
+{
+    static FrameBuffer *frame_buffer = new FrameBuffer;
+    return *frame_buffer;
+}
+
+void Screen::attach()
+{
+    if (!previous)
+        previous = std::cout.rdbuf(&buffer());
+}
+
+void Screen::detach()
+{
+    present();
+    if (previous)
+        std::cout.rdbuf(previous);
+    previous = nullptr;
+}
+
+TerminalSession::TerminalSession()
+{
+    if (tcgetattr(STDIN_FILENO, &original) < 0)
+    {
+        perror("tcgetattr()");
+        return;
+    }
+    struct termios raw = original;
+    raw.c_lflag &= ~(ICANON | ECHO);
+    raw.c_iflag &= ~ISTRIP; // keep the 8th bit of UTF-8 bytes
+    raw.c_cc[VMIN] = 1;
+    raw.c_cc[VTIME] = 0;
+    if (tcsetattr(STDIN_FILENO, TCSANOW, &raw) < 0)
+    {
+        perror("tcsetattr ICANON");
+        return;
+    }
+    active = true;
+    Screen::attach();
+    Screen::frame() += ALTERNATE_SCREEN_ON;
+    Screen::present();
+
+    static bool handlers_installed = false;
+    if (!handlers_installed)
+    {
+        std::atexit(TerminalSession::restore);
+        for (int signal : restored_signals)
+            std::signal(signal, TerminalSession::handle_signal);
+        handlers_installed = true;
+    }
+}
+
+TerminalSession::~TerminalSession()
+{
+    Screen::detach();
+    restore();
+}
+
+void TerminalSession::restore()
+{
+    if (!active)
+        return;
+    active = false;
+    ssize_t written = write(STDOUT_FILENO, ALTERNATE_SCREEN_OFF, sizeof(ALTERNATE_SCREEN_OFF) - 1);
+    (void)written;
+    tcsetattr(STDIN_FILENO, TCSADRAIN, &original);
+}
+
+void TerminalSession::handle_signal(int signal)
+{
+    restore();
+    std::signal(signal, SIG_DFL);
+    raise(signal);
+}
+
+key_event get_key()
+{
+    key_event event;
+    while (!decoder.next(event))
+    {
+        if (input_begin == input_end)
+        {
+            //? the rest of a started escape sequence is waited for only briefly, a lone ESC is the escape key
+            if (decoder.pending() && !wait_for_input(ESCAPE_TIMEOUT_MS))
+            {
+                decoder.timeout();
+                continue;
+            }
+            if (!read_input())
+                return {key_type::NONE, 0};
+        }
+        decode_input();
+    }
+    return event;
+}
+
+EventLoop::EventLoop(uint32_t tick_hz) : tick_interval_ns(1000000000ull / (tick_hz == 0 ? 1 : tick_hz))
+{
+    this->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    this->alarm_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (this->timer_fd < 0 || this->alarm_fd < 0)
+        perror("timerfd_create()");
+}
+
+EventLoop::~EventLoop()
+{
+    if (this->timer_fd >= 0)
+        close(this->timer_fd);
+    if (this->alarm_fd >= 0)
+        close(this->alarm_fd);
+}
+
+void EventLoop::set_ticking(bool on)
+{
+    if (this->timer_fd < 0)
+        return;
+    struct itimerspec spec = {};
+    if (on)
+    {
+        spec.it_interval.tv_sec = this->tick_interval_ns / 1000000000;
+        spec.it_interval.tv_nsec = this->tick_interval_ns % 1000000000;
+        spec.it_value = spec.it_interval;
+    }
+    timerfd_settime(this->timer_fd, 0, &spec, nullptr);
+}
+
+void EventLoop::set_alarm(uint64_t at_ns)
+{
+    if (this->alarm_fd < 0)
+        return;
+    //? the steady clock is CLOCK_MONOTONIC, so key timestamps and alarm times compare directly
+    struct itimerspec spec = {};
+    spec.it_value.tv_sec = at_ns / 1000000000;
+    spec.it_value.tv_nsec = at_ns % 1000000000;
+    timerfd_settime(this->alarm_fd, TFD_TIMER_ABSTIME, &spec, nullptr);
+}
+
+terminal_event EventLoop::next()
+{
+    key_event key;
+    while (true)
+    {
+        decode_input();
+        if (decoder.next(key))
+            return {event_type::KEY, key, input_timestamp_ns};
+        if (decoder.pending() && !wait_for_input(ESCAPE_TIMEOUT_MS))
+        {
+            decoder.timeout();
+            continue;
+        }
+
+        //? poll() ignores negative descriptors, so an unwatched slot costs nothing
+        struct pollfd fds[5] = {{STDIN_FILENO, POLLIN, 0}, {this->timer_fd, POLLIN, 0}, {TerminalGeometry::fd(), POLLIN, 0},
+                                {this->watched_fd, POLLIN, 0}, {this->alarm_fd, POLLIN, 0}};
+        int ready;
+        do
+            ready = poll(fds, 5, -1);
+        while (ready < 0 && errno == EINTR);
+        if (ready < 0)
+        {
+            perror("poll()");
+            return {event_type::KEY, {key_type::NONE, 0}, now_ns()};
+        }
+        //? input is read first, so a key coming together with a tick is timestamped before the tick is rendered
+        if (fds[0].revents != 0 && !read_input())
+            return {event_type::KEY, {key_type::NONE, 0}, input_timestamp_ns};
+        if (fds[0].revents != 0)
+            continue;
+        if (fds[2].revents & POLLIN)
+        {
+            TerminalGeometry::size(); // drains the self-pipe
+            return {event_type::RESIZE, {key_type::NONE, 0}, now_ns()};
+        }
+        if (fds[3].revents != 0)
+            return {event_type::SOCKET, {key_type::NONE, 0}, now_ns()};
+        for (int i : {1, 4})
+            if (fds[i].revents & POLLIN)
+            {
+                uint64_t expirations;
+                ssize_t count = read(fds[i].fd, &expirations, sizeof(expirations));
+                (void)count;
+                return {event_type::TICK, {key_type::NONE, 0}, now_ns()};
+            }
+    }
+}
+
+bool input_buffered()
+{
+    return input_begin != input_end || decoder.ready();
+}
@@ -0,0 +1,196 @@
+#pragma once
+
+#include "input.h"
+
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <streambuf>
+#include <string>
+#include <termios.h>
+
+#define INPUT_BUFFER_SIZE 256
+
+#define ALTERNATE_SCREEN_ON "\033[?1049h"
+#define ALTERNATE_SCREEN_OFF "\033[?1049l"
+#define CLEAR_SCREEN "\033[H\033[2J"
+
+#define DEFAULT_TERMINAL_WIDTH 80
+#define DEFAULT_TERMINAL_HEIGHT 24
+
+#define STATS_REFRESH_HZ 10 // rate the stats of a running test are redrawn at while no key comes
+
+struct terminal_size
+{
+    int width, height;
+
+    bool operator==(const terminal_size &other) const
+    {
+        return width == other.width && height == other.height;
+    }
+
+    bool operator!=(const terminal_size &other) const
+    {
+        return !(*this == other);
+    }
+};
+
+/// @brief terminal size cache, the size is queried with ioctl only after SIGWINCH reported a resize
+class TerminalGeometry
+{
+private:
+    static terminal_size cached;
+    static volatile sig_atomic_t resized;
+    static int pipe_fds[2];
+    static bool installed;
+
+    /// @brief mark the cached size stale and wake whoever waits on fd()
+    static void handle_resize(int signal);
+
+    /// @brief install SIGWINCH handler and create the self-pipe
+    static void install();
+
+    /// @brief query the terminal size (falls back to the default size when stdout is not a terminal)
+    static void query();
+
+public:
+    TerminalGeometry() = delete;
+
+    /// @return current terminal size, costs no syscall unless the terminal was resized since the last call
+    static terminal_size size();
+
+    /// @return read end of the self-pipe, readable after every resize (drained by size())
+    static int fd();
+};
+
+/// @brief collects everything printed during one frame, std::cout writes into it while a session is active
+class FrameBuffer : public std::streambuf
+{
+private:
+    std::string data;
+
+protected:
+    int_type overflow(int_type ch) override;
+    std::streamsize xsputn(const char *s, std::streamsize count) override;
+
+    /// @brief flushing std::cout does not send anything, frames are sent by present()
+    int sync() override { return 0; }
+
+public:
+    /// @return content of the current frame
+    std::string &frame() { return this->data; }
+
+    /// @brief send the current frame with a single write() and start a new one
+    void present();
+};
+
+/// @brief in-process screen control, all output of a frame goes out in one write()
+class Screen
+{
+private:
+    static std::streambuf *previous;
+
+public:
+    Screen() = delete;
+
+    /// @return buffer shared by std::cout and the renderer (never destroyed, so std::cout may point to it until exit)
+    static FrameBuffer &buffer();
+
+    /// @brief redirect std::cout into the frame buffer
+    static void attach();
+
+    /// @brief send what is left and give std::cout its own buffer back
+    static void detach();
+
+    /// @return content of the current frame
+    static std::string &frame() { return buffer().frame(); }
+
+    /// @brief send the current frame with a single write()
+    static void present() { buffer().present(); }
+
+    /// @brief clear the screen and move the cursor home as a part of the current frame
+    static void clear() { buffer().frame() += CLEAR_SCREEN; }
+};
+
+/// @brief puts the terminal into raw mode (no line buffering, no echo) on the alternate screen for its lifetime,
+/// the original mode and screen are also restored on exit() and on fatal signals
+class TerminalSession
+{
+private:
+    static struct termios original;
+    static volatile bool active;
+
+    /// @brief restore the terminal and re-raise the signal with its default action
+    static void handle_signal(int signal);
+
+public:
+    TerminalSession();
+    ~TerminalSession();
+    TerminalSession(const TerminalSession &) = delete;
+    TerminalSession &operator=(const TerminalSession &) = delete;
+
+    /// @brief bring back the terminal mode saved when the session began (async-signal-safe)
+    static void restore();
+};
+
+enum class event_type
+{
+    KEY,   // key pressed (key_type::NONE if stdin is closed)
+    TICK,   // timer tick or alarm
+    RESIZE, // terminal resized
+    SOCKET  // watched descriptor readable (see EventLoop::watch)
+};
+
+struct terminal_event
+{
+    event_type type;
+    key_event key;
+    uint64_t timestamp_ns; // steady clock time the key was read at (see now_ns)
+};
+
+/// @brief waits for stdin, a timerfd ticking at a fixed rate, a one-shot alarm timerfd, the SIGWINCH self-pipe and an
+/// optional watched descriptor with a single poll(), so nothing runs until one of them is ready and no CPU is used
+/// while idle. Keys are timestamped when they are read, before anything is rendered
+class EventLoop
+{
+private:
+    int timer_fd = -1;
+    int alarm_fd = -1;
+    int watched_fd = -1;
+    uint64_t tick_interval_ns;
+
+public:
+    /// @param tick_hz ticks per second while ticking is on
+    explicit EventLoop(uint32_t tick_hz);
+    ~EventLoop();
+    EventLoop(const EventLoop &) = delete;
+    EventLoop &operator=(const EventLoop &) = delete;
+
+    /// @brief start or stop timer ticks (off after construction)
+    /// @param on true to tick
+    void set_ticking(bool on);
+
+    /// @brief one tick at given time (e.g. when something drawn has to move next), replaces the previous alarm
+    /// @param at_ns steady clock time in nanoseconds (see now_ns), 0 to cancel the alarm
+    void set_alarm(uint64_t at_ns);
+
+    /// @brief report readability of a descriptor (e.g. a socket) as event_type::SOCKET, it has to be read before the
+    /// next call, otherwise the event repeats
+    /// @param fd descriptor to watch, -1 to stop watching
+    void watch(int fd) { this->watched_fd = fd; }
+
+    /// @brief block until the next event, already read keys come first
+    /// @return key, tick, resize or readable watched descriptor
+    terminal_event next();
+};
+
+/// @return steady clock time in nanoseconds, key timestamps are taken from this clock
+uint64_t now_ns();
+
+/// @brief get one key from stdin without the need of pressing enter, input is read in bulk and every chunk is decoded
+/// in one pass (see KeyDecoder), so the following keys of a burst or paste are served without a syscall
+/// @return key pressed, key_type::NONE if stdin is closed
+key_event get_key();
+
+/// @return true if already read input is waiting in the buffer
+bool input_buffered();
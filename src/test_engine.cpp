@@ -0,0 +1,122 @@
+#include "test_engine.h"
+
+void TestEngine::set_goal(const std::string &goal)
+{
+    this->text.close();
+    this->streaming = false;
+    this->results.goal = goal;
+    this->graphemes.build(this->results.goal);
+    this->reset();
+}
+
+void TestEngine::swap_goal(std::string &goal, GraphemeIndex &graphemes)
+{
+    this->text.close();
+    this->streaming = false;
+    std::swap(this->results.goal, goal);
+    std::swap(this->graphemes, graphemes);
+    this->reset();
+}
+
+bool TestEngine::open_text(const std::string &filepath)
+{
+    this->streaming = true;
+    this->results.goal.clear();
+    this->graphemes.clear();
+    const bool opened = this->text.open(filepath);
+    this->reset();
+    return opened;
+}
+
+void TestEngine::open_words(text_source source)
+{
+    this->streaming = true;
+    this->results.goal.clear();
+    this->graphemes.clear();
+    this->text.open(std::move(source));
+    this->reset();
+}
+
+void TestEngine::reset()
+{
+    if (this->streaming)
+        this->text.rewind();
+    this->typed_bytes = 0;
+    this->started = false;
+    this->begin_ns = 0;
+    this->results.time = 0;
+    this->results.user_score = 0;
+    this->results.input_count = 0;
+    this->recorder.clear();
+    this->progress_ms.clear();
+    //? reserved once per goal, so recording the timeline never allocates while typing
+    if (!this->streaming)
+        this->progress_ms.reserve(this->graphemes.size());
+    this->follow();
+}
+
+void TestEngine::set_view(int width, uint32_t lines_behind, uint32_t lines_ahead)
+{
+    this->behind = lines_behind;
+    this->ahead = lines_ahead;
+    this->text.set_width(width);
+    this->follow();
+}
+
+char32_t TestEngine::expected() const
+{
+    const std::string_view grapheme = this->expected_grapheme();
+    char32_t codepoint = 0;
+    if (this->typed_bytes < grapheme.size())
+        decode_utf8(grapheme.data() + this->typed_bytes, grapheme.data() + grapheme.size(), codepoint);
+    return codepoint;
+}
+
+key_outcome TestEngine::type(uint64_t timestamp_ns, char32_t typed)
+{
+    if (this->finished())
+        return key_outcome::WRONG;
+    if (!this->started)
+    {
+        this->started = true;
+        this->begin_ns = timestamp_ns;
+    }
+    this->update_time(timestamp_ns);
+    if (this->time_over())
+        return key_outcome::WRONG;
+
+    //? a grapheme of several codepoints (e.g. a letter with a combining mark) is typed one codepoint at a time
+    char32_t expected;
+    const std::string_view grapheme = this->expected_grapheme();
+    const std::size_t length = decode_utf8(grapheme.data() + this->typed_bytes, grapheme.data() + grapheme.size(), expected);
+    this->recorder.record(timestamp_ns, expected, typed);
+    if (typed == expected && this->typed_bytes + length < grapheme.size())
+    {
+        this->typed_bytes += length;
+        return key_outcome::PARTIAL;
+    }
+    this->typed_bytes = 0;
+    ++this->results.input_count;
+    if (typed != expected)
+        return key_outcome::WRONG;
+    ++this->results.user_score;
+    if (!this->streaming)
+        this->progress_ms.push_back((timestamp_ns - this->begin_ns) / 1000000);
+    this->follow();
+    return key_outcome::CORRECT;
+}
+
+uint64_t TestEngine::words_amount() const
+{
+    if (this->streaming)
+        return this->text.words_before(this->results.user_score);
+    uint64_t count = 0;
+    bool in_word = false;
+    for (char c : this->results.goal)
+    {
+        if (c != ' ' && !in_word)
+            ++count;
+        in_word = c != ' ';
+    }
+    return count;
+}
@@ -0,0 +1,180 @@
+#pragma once
+
+#include "keystrokes.h"
+#include "text_stream.h"
+#include "utf8.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct test_result
+{
+    int64_t time;
+    uint32_t user_score;
+    uint32_t input_count;
+    std::string goal;
+};
+
+/// @brief what a typed key did to the test
+enum class key_outcome
+{
+    PARTIAL, // correct codepoint of a grapheme made of several codepoints, the grapheme isn't finished yet
+    CORRECT, // grapheme typed
+    WRONG    // wrong character, the position doesn't move
+};
+
+/// @brief scoring and progress of one typing test without any terminal I/O: the goal (generated words or a streamed
+/// text), the typing position, recorded keystrokes and the accuracy, time and WPM derived from them. Driven by key
+/// events with timestamps, either by the interactive test loop or by a replay
+class TestEngine
+{
+private:
+    test_result results = {0, 0, 0, ""};
+    GraphemeIndex graphemes;
+    TextStream text;
+    bool streaming = false;
+    uint32_t typed_bytes = 0; // bytes of the current grapheme already typed (graphemes of several codepoints)
+    bool started = false;
+    uint64_t begin_ns = 0; // timestamp of the first key
+    int64_t time_limit_ms = 0; // 0 for no limit
+    KeystrokeRecorder recorder;
+    std::vector<uint32_t> progress_ms; // time from the first key every grapheme of goal words was typed at
+    uint32_t behind = 0, ahead = 1; // lines kept around the typing position of a streamed text
+
+    /// @brief keep the lines of the streamed text around the typing position
+    void follow()
+    {
+        if (this->streaming)
+            this->text.advance(this->results.user_score, this->behind, this->ahead);
+    }
+
+public:
+    TestEngine() = default;
+    TestEngine(const TestEngine &) = delete;
+    TestEngine &operator=(const TestEngine &) = delete;
+
+    /// @brief use given words as the goal and reset the progress
+    /// @param goal UTF-8 goal
+    void set_goal(const std::string &goal);
+
+    /// @brief same as set_goal(goal) for an already indexed goal, the previous goal and its index are swapped into the arguments
+    /// @param goal UTF-8 goal, replaced with the previous goal
+    /// @param graphemes index of the goal, replaced with the previous index
+    void swap_goal(std::string &goal, GraphemeIndex &graphemes);
+
+    /// @brief use text file streamed in chunks as the goal and reset the progress
+    /// @param filepath path to the text
+    /// @return false if the file can't be opened (the goal is then empty)
+    bool open_text(const std::string &filepath);
+
+    /// @brief use endless text supplied by given source as the goal (timed tests) and reset the progress
+    /// @param source supplier of the text, called again for more text before the lines ahead run out
+    void open_words(text_source source);
+
+    /// @brief limit the test time, the test is finished when the time from the first key reaches the limit
+    /// (kept for the following goals)
+    /// @param milliseconds time limit, 0 for no limit
+    void set_time_limit(int64_t milliseconds) { this->time_limit_ms = milliseconds; }
+
+    /// @brief reset the progress keeping the goal (a streamed text starts from the beginning)
+    void reset();
+
+    /// @brief wrap the streamed text to given width and keep given lines around the typing position (no effect for words)
+    /// @param width terminal columns per line
+    /// @param lines_behind number of lines kept above the line of the typing position
+    /// @param lines_ahead number of lines wrapped below the line of the typing position
+    void set_view(int width, uint32_t lines_behind, uint32_t lines_ahead);
+
+    /// @brief score typed character, the test time runs from the first key to the last one
+    /// @param timestamp_ns time of the key in nanoseconds (any steady clock)
+    /// @param typed typed codepoint
+    /// @return what the key did (WRONG once the goal is finished, keys after the time limit aren't scored)
+    key_outcome type(uint64_t timestamp_ns, char32_t typed);
+
+    /// @brief set the test time to the time from the first key to given time (no effect before the first key), the
+    /// time doesn't go past the time limit
+    /// @param now_ns current time in nanoseconds (same clock as the key timestamps)
+    void update_time(uint64_t now_ns)
+    {
+        if (!this->started)
+            return;
+        this->results.time = (now_ns - this->begin_ns) / 1000000;
+        if (this->time_limit_ms != 0 && this->results.time > this->time_limit_ms)
+            this->results.time = this->time_limit_ms;
+    }
+
+    /// @return true if the time limit is reached
+    bool time_over() const { return this->time_limit_ms != 0 && this->results.time >= this->time_limit_ms; }
+
+    /// @return true if the whole goal is typed or the time is over
+    bool finished() const
+    {
+        if (this->time_over())
+            return true;
+        return this->streaming ? this->text.finished(this->results.user_score)
+                               : this->results.user_score == this->graphemes.size();
+    }
+
+    /// @return grapheme to be typed next
+    std::string_view expected_grapheme() const
+    {
+        return this->streaming ? this->text.at(this->results.user_score) : this->graphemes.grapheme(this->results.goal, this->results.user_score);
+    }
+
+    /// @return codepoint to be typed next
+    char32_t expected() const;
+
+    /// @return true once the first key is typed
+    bool is_started() const { return this->started; }
+
+    /// @return steady clock time of the first key in nanoseconds (0 before the first key)
+    uint64_t begin_time_ns() const { return this->begin_ns; }
+
+    /// @return true if the goal is a streamed text, else it's goal()
+    bool is_streaming() const { return this->streaming; }
+
+    /// @return goal words ("" for a streamed text)
+    const std::string &goal() const { return this->results.goal; }
+
+    /// @return grapheme index of the goal words
+    const GraphemeIndex &goal_graphemes() const { return this->graphemes; }
+
+    /// @return streamed text
+    const TextStream &stream() const { return this->text; }
+
+    /// @return typed graphemes
+    uint32_t score() const { return this->results.user_score; }
+
+    /// @return finished graphemes, typed correctly or not
+    uint32_t input_count() const { return this->results.input_count; }
+
+    /// @return time limit in milliseconds (0 for no limit)
+    int64_t time_limit() const { return this->time_limit_ms; }
+
+    /// @return test time in milliseconds
+    int64_t time_ms() const { return this->results.time; }
+
+    /// @return test time in seconds
+    float time_s() const { return this->results.time / 1000.f; }
+
+    /// @return test accuracy
+    float accuracy() const { return this->results.input_count == 0 ? 0.f : (float)this->results.user_score / this->results.input_count; }
+
+    /// @return test WPM
+    float wpm() const { return this->results.time == 0 ? 0.f : (this->results.user_score / 5.f) / (this->results.time / 60000.f); }
+
+    /// @return goal characters (graphemes) amount
+    uint32_t characters_amount() const { return this->graphemes.size(); }
+
+    /// @return goal word count (for streamed texts words started before the typing position)
+    uint64_t words_amount() const;
+
+    /// @return keystrokes of the test
+    const KeystrokeRecorder &keystrokes() const { return this->recorder; }
+
+    /// @return milliseconds from the first key at which the n-th grapheme of the goal words was typed, one entry per
+    /// typed grapheme (empty for streamed texts)
+    const std::vector<uint32_t> &timeline() const { return this->progress_ms; }
+};
@@ -0,0 +1,204 @@
+#include "text_stream.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/// @return true for characters typed as a single space when they form a run
+static bool is_blank(char c)
+{
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\v' || c == '\f';
+}
+
+TextStream::~TextStream()
+{
+    this->close();
+}
+
+bool TextStream::open(const std::string &filepath)
+{
+    this->close();
+    this->fd = ::open(filepath.c_str(), O_RDONLY);
+    if (this->fd < 0)
+        return false;
+    struct stat file_stat;
+    if (fstat(this->fd, &file_stat) == 0)
+        this->file_size = file_stat.st_size;
+    posix_fadvise(this->fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    this->rewind();
+    return true;
+}
+
+void TextStream::open(text_source source)
+{
+    this->close();
+    this->source = std::move(source);
+    this->rewind();
+}
+
+void TextStream::close()
+{
+    if (this->fd >= 0)
+        ::close(this->fd);
+    this->fd = -1;
+    this->source = nullptr;
+    this->file_size = 0;
+    this->rewind();
+}
+
+void TextStream::rewind()
+{
+    if (this->fd >= 0)
+        lseek(this->fd, 0, SEEK_SET);
+    this->eof = this->fd < 0 && !this->source;
+    this->pending_space = false;
+    this->buffer.clear();
+    this->index.clear();
+    this->buffer_offset = 0;
+    this->lines.clear();
+    this->first_line_number = 0;
+    this->next_line = {0, 0, 0, false};
+}
+
+void TextStream::set_width(int width)
+{
+    width = width <= 0 ? 1 : width;
+    if (width == this->width)
+        return;
+    this->width = width;
+    if (this->lines.empty())
+        return;
+    this->next_line = this->lines.front();
+    this->lines.clear();
+}
+
+bool TextStream::read_chunk()
+{
+    if (this->eof)
+        return false;
+    ssize_t count;
+    if (this->source)
+    {
+        this->chunk.clear();
+        count = this->source(this->chunk) ? this->chunk.size() : 0;
+    }
+    else
+    {
+        this->chunk.resize(STREAM_CHUNK_SIZE);
+        do
+            count = read(this->fd, &this->chunk[0], this->chunk.size());
+        while (count < 0 && errno == EINTR);
+    }
+    if (count <= 0)
+    {
+        this->eof = true;
+        this->index.append(this->buffer, true);
+        return false;
+    }
+    for (ssize_t i = 0; i < count; ++i)
+    {
+        const char c = this->chunk[i];
+        if (is_blank(c))
+            this->pending_space = this->buffer_offset > 0 || !this->buffer.empty();
+        else
+        {
+            if (this->pending_space)
+                this->buffer += ' ';
+            this->pending_space = false;
+            this->buffer += c;
+        }
+    }
+    this->index.append(this->buffer, false);
+    return true;
+}
+
+bool TextStream::wrap_next_line()
+{
+    text_line line = this->next_line;
+    while (this->columns_from(line.begin) < (uint32_t)this->width && this->read_chunk())
+        ;
+    const std::size_t first = line.begin - this->buffer_offset, available = this->index.size() - first;
+    if (available == 0)
+        return false;
+
+    bool broken = false;
+    if (this->eof && this->columns_from(line.begin) <= (uint32_t)this->width)
+        line.length = available;
+    else
+    {
+        //? graphemes fitting into the width, at least one even if it's wider
+        std::size_t fitting = 1;
+        while (first + fitting < this->index.size() && this->index.column(first + fitting + 1) - this->index.column(first) <= (uint32_t)this->width)
+            ++fitting;
+        line.length = fitting;
+        while (line.length > 0 && !this->is_space(first + line.length - 1))
+            --line.length;
+        if (line.length == 0)
+        {
+            line.length = fitting;
+            broken = true;
+        }
+    }
+    this->lines.push_back(line);
+
+    uint64_t words = line.words_before;
+    for (std::size_t i = first; i < first + line.length; ++i)
+        if (!this->is_space(i) && (i == first ? !line.continued : this->is_space(i - 1)))
+            ++words;
+    this->next_line = {line.begin + line.length, 0, words, broken};
+    return true;
+}
+
+void TextStream::advance(uint64_t position, uint32_t behind, uint32_t ahead)
+{
+    if (this->lines.empty() && !this->wrap_next_line())
+        return;
+    while (this->lines.back().begin + this->lines.back().length <= position && this->wrap_next_line())
+        ;
+    std::size_t index = this->line_index_of(position);
+    while (this->lines.size() - 1 - index < ahead && this->wrap_next_line())
+        ;
+    for (; index > behind; --index)
+    {
+        this->lines.pop_front();
+        ++this->first_line_number;
+    }
+
+    //? typed text is dropped from the buffer once there is a chunk of it, so the erase cost is spread over many keystrokes
+    const uint64_t typed = this->lines.front().begin - this->buffer_offset;
+    if (this->index.offset(typed) >= STREAM_CHUNK_SIZE)
+    {
+        this->buffer.erase(0, this->index.offset(typed));
+        this->index.erase_front(typed);
+        this->buffer_offset += typed;
+    }
+}
+
+std::size_t TextStream::line_index_of(uint64_t position) const
+{
+    for (std::size_t i = 0; i < this->lines.size(); ++i)
+        if (position < this->lines[i].begin + this->lines[i].length)
+            return i;
+    return this->lines.empty() ? 0 : this->lines.size() - 1;
+}
+
+std::string_view TextStream::text_between(uint64_t from, uint64_t to) const
+{
+    const uint32_t begin = this->index.offset(from - this->buffer_offset), end = this->index.offset(to - this->buffer_offset);
+    return std::string_view(this->buffer.data() + begin, end - begin);
+}
+
+uint64_t TextStream::words_before(uint64_t position) const
+{
+    if (this->lines.empty())
+        return 0;
+    const text_line &line = this->lines[this->line_index_of(position)];
+    const std::size_t first = line.begin - this->buffer_offset, end = std::min<uint64_t>(position, line.begin + line.length) - this->buffer_offset;
+    uint64_t words = line.words_before;
+    for (std::size_t i = first; i < end; ++i)
+        if (!this->is_space(i) && (i == first ? !line.continued : this->is_space(i - 1)))
+            ++words;
+    return words;
+}
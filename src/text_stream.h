@@ -0,0 +1,145 @@
+#pragma once
+
+#include "utf8.h"
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <string>
+#include <string_view>
+
+#define STREAM_CHUNK_SIZE 65536
+
+/// @brief supplier of a text generated on the fly (instead of a file), called whenever more text is needed
+/// @param chunk empty string the next part of the text is appended to
+/// @return false if the text has ended
+using text_source = std::function<bool(std::string &chunk)>;
+
+/// @brief one wrapped line of a streamed text, positions and lengths count graphemes
+struct text_line
+{
+    uint64_t begin;        // position of the first grapheme in the whole text
+    uint32_t length;       // graphemes in the line, including the space it ends with
+    uint64_t words_before; // words started before the line
+    bool continued;        // the line begins inside a word broken at the end of the previous line
+};
+
+/// @brief text file of any size (or endless text from a text_source) read lazily in chunks of STREAM_CHUNK_SIZE bytes, whitespace runs (new lines included)
+/// are typed as a single space. The UTF-8 text is indexed by grapheme and wrapped into lines of given display width,
+/// only the lines around the typing position are kept in memory, so memory and cost per keystroke don't depend on
+/// the text length
+class TextStream
+{
+private:
+    int fd = -1;
+    text_source source;
+    uint64_t file_size = 0;
+    bool eof = true;
+    bool pending_space = false;
+    std::string buffer;         // normalized text from the first kept line to the last read character
+    GraphemeIndex index;        // graphemes of the buffer (the last one is indexed once it's known to be complete)
+    uint64_t buffer_offset = 0; // position of the first grapheme of the buffer in the whole text
+    std::deque<text_line> lines;
+    uint64_t first_line_number = 0;
+    text_line next_line = {0, 0, 0, false}; // start of the line wrapped next
+    std::string chunk;
+    int width = 80;
+
+    /// @return position right after the last indexed grapheme
+    uint64_t loaded_end() const { return this->buffer_offset + this->index.size(); }
+
+    /// @param position position in the buffer
+    /// @return display width of the indexed text from given position
+    uint32_t columns_from(uint64_t position) const { return this->index.column(this->index.size()) - this->index.column(position - this->buffer_offset); }
+
+    /// @param i grapheme number in the buffer
+    /// @return true if the grapheme is a space
+    bool is_space(std::size_t i) const { return this->index.offset(i + 1) - this->index.offset(i) == 1 && this->buffer[this->index.offset(i)] == ' '; }
+
+    /// @brief read the next chunk of the file and append its normalized text to the buffer
+    /// @return false if nothing more can be read
+    bool read_chunk();
+
+    /// @brief wrap the line following the last kept one
+    /// @return false if the whole text is already wrapped
+    bool wrap_next_line();
+
+public:
+    TextStream() = default;
+    ~TextStream();
+    TextStream(const TextStream &) = delete;
+    TextStream &operator=(const TextStream &) = delete;
+
+    /// @brief open text file, it's read when its lines are needed (see advance)
+    /// @param filepath path to the text
+    /// @return true if the file was opened, on failure the stream is empty
+    bool open(const std::string &filepath);
+
+    /// @brief use text supplied by given source, it's requested when its lines are needed (see advance)
+    /// @param source supplier of the text
+    void open(text_source source);
+
+    /// @brief close the file (or forget the source) and drop the kept text
+    void close();
+
+    /// @brief start again from the beginning of the text (a source continues with its next text)
+    void rewind();
+
+    /// @brief change the wrapping width, the kept lines are wrapped again from the first one
+    /// @param width terminal columns per line
+    void set_width(int width);
+
+    /// @brief keep lines needed around the typing position, older lines are dropped and further ones read
+    /// @param position typing position
+    /// @param behind number of lines kept above the line of the position
+    /// @param ahead number of lines wrapped below the line of the position
+    void advance(uint64_t position, uint32_t behind, uint32_t ahead);
+
+    /// @param position typing position
+    /// @return true if the whole text is typed
+    bool finished(uint64_t position) const { return this->eof && position >= this->loaded_end(); }
+
+    /// @param position position in the kept lines
+    /// @return grapheme to be typed at given position
+    std::string_view at(uint64_t position) const { return this->index.grapheme(this->buffer, position - this->buffer_offset); }
+
+    /// @return number of kept lines
+    std::size_t kept_lines() const { return this->lines.size(); }
+
+    /// @param index index of a kept line
+    /// @return wrapped line
+    const text_line &line(std::size_t index) const { return this->lines[index]; }
+
+    /// @param index index of a kept line
+    /// @return characters of the line
+    std::string_view line_text(std::size_t index) const { return this->text_between(this->lines[index].begin, this->lines[index].begin + this->lines[index].length); }
+
+    /// @param from position in the kept lines
+    /// @param to following position in the kept lines (or right after the text)
+    /// @return characters between the positions
+    std::string_view text_between(uint64_t from, uint64_t to) const;
+
+    /// @param index index of a kept line
+    /// @param position position in the line (or right after it)
+    /// @return display column of the position counted from the line start
+    uint32_t column_in_line(std::size_t index, uint64_t position) const { return this->index.column(position - this->buffer_offset) - this->index.column(this->lines[index].begin - this->buffer_offset); }
+
+    /// @param position position in the kept lines (or right after the text)
+    /// @return index of the kept line containing the position
+    std::size_t line_index_of(uint64_t position) const;
+
+    /// @param index index of a kept line
+    /// @return number of the line in the whole wrapped text
+    uint64_t line_number(std::size_t index) const { return this->first_line_number + index; }
+
+    /// @param position position in the kept lines (or right after the text)
+    /// @return number of words started before the position
+    uint64_t words_before(uint64_t position) const;
+
+    /// @return length of the text if it's read to the end, else the file size (the text is never longer), the read
+    /// length for a source
+    uint64_t length_hint() const { return this->eof || this->source ? this->loaded_end() : this->file_size; }
+
+    /// @return true if length_hint() is the exact text length
+    bool length_known() const { return this->eof; }
+};
@@ -0,0 +1,173 @@
+#include "timeline.h"
+#include "varint.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+TimelineStore::TimelineStore(std::string path) : path(std::move(path)) {}
+
+TimelineStore::~TimelineStore()
+{
+    if (this->fd >= 0)
+        close(this->fd);
+}
+
+uint64_t TimelineStore::goal_id(const std::string &goal)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : goal)
+    {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+void TimelineStore::encode(const timeline &run, std::string &output)
+{
+    uint32_t previous = 0;
+    for (uint32_t ms : run)
+    {
+        append_varint(output, ms - previous);
+        previous = ms;
+    }
+}
+
+bool TimelineStore::decode(const char *data, const char *end, timeline &run)
+{
+    run.clear();
+    uint64_t delta, ms = 0;
+    while (data < end)
+    {
+        if (!read_varint(data, end, delta))
+            return false;
+        ms += delta;
+        run.push_back(ms);
+    }
+    return true;
+}
+
+void TimelineStore::consider(uint64_t goal_id, uint32_t goal_graphemes, uint32_t typed, uint32_t total_ms, uint32_t offset)
+{
+    if (typed != goal_graphemes || typed == 0)
+        return;
+    auto found = this->best.find(goal_id);
+    if (found == this->best.end() || total_ms < found->second.total_ms)
+        this->best[goal_id] = {offset, total_ms};
+}
+
+void TimelineStore::index()
+{
+    this->indexed = true;
+    int file = open(this->path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (file < 0)
+        return;
+    struct stat file_stat;
+    if (fstat(file, &file_stat) < 0 || file_stat.st_size < 5)
+    {
+        close(file);
+        return;
+    }
+    const std::size_t length = file_stat.st_size;
+    void *mapped = mmap(nullptr, length, PROT_READ, MAP_SHARED, file, 0);
+    close(file);
+    if (mapped == MAP_FAILED)
+        return;
+
+    //? only the record headers are read, the pages of the payloads in between are never touched
+    const char *begin = static_cast<const char *>(mapped), *data = begin + 5, *end = begin + length;
+    uint64_t goal_id, goal_graphemes, typed, total_ms, payload_length;
+    if (std::memcmp(begin, TIMELINE_STORE_MAGIC, 4) == 0 && begin[4] == TIMELINE_STORE_VERSION)
+        while (data < end)
+        {
+            const uint32_t offset = data - begin;
+            if (!read_varint(data, end, goal_id) || !read_varint(data, end, goal_graphemes) || !read_varint(data, end, typed) ||
+                !read_varint(data, end, total_ms) || !read_varint(data, end, payload_length) ||
+                payload_length > static_cast<uint64_t>(end - data))
+                break; // torn record of an interrupted append
+            this->consider(goal_id, goal_graphemes, typed, total_ms, offset);
+            data += payload_length;
+        }
+    munmap(mapped, length);
+}
+
+uint32_t TimelineStore::append(uint64_t goal_id, uint32_t goal_graphemes, const timeline &run)
+{
+    if (this->fd < 0)
+    {
+        std::error_code ec;
+        const std::filesystem::path directory = std::filesystem::path(this->path).parent_path();
+        if (!directory.empty())
+            std::filesystem::create_directories(directory, ec);
+        this->fd = open(this->path.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+        if (this->fd < 0)
+            return 0;
+        struct stat file_stat;
+        if (fstat(this->fd, &file_stat) < 0)
+            return 0;
+        if (file_stat.st_size == 0)
+        {
+            const char header[5] = {TIMELINE_STORE_MAGIC[0], TIMELINE_STORE_MAGIC[1], TIMELINE_STORE_MAGIC[2], TIMELINE_STORE_MAGIC[3], TIMELINE_STORE_VERSION};
+            if (write(this->fd, header, sizeof(header)) != sizeof(header))
+                return 0;
+        }
+    }
+    if (!this->indexed)
+        this->index();
+
+    std::string payload, record;
+    encode(run, payload);
+    const uint32_t total_ms = run.empty() ? 0 : run.back();
+    append_varint(record, goal_id);
+    append_varint(record, goal_graphemes);
+    append_varint(record, run.size());
+    append_varint(record, total_ms);
+    append_varint(record, payload.size());
+    record += payload;
+
+    const off_t offset = lseek(this->fd, 0, SEEK_END);
+    if (offset < 0 || write(this->fd, record.data(), record.size()) != static_cast<ssize_t>(record.size()))
+        return 0;
+    this->consider(goal_id, goal_graphemes, run.size(), total_ms, offset);
+    return offset + 1;
+}
+
+bool TimelineStore::fastest(uint64_t goal_id, timeline &run)
+{
+    run.clear();
+    if (!this->indexed)
+        this->index();
+    auto found = this->best.find(goal_id);
+    if (found == this->best.end())
+        return false;
+
+    std::ifstream file(this->path, std::ios::binary);
+    file.seekg(found->second.offset);
+    //? a record header is at most 5 varints of up to 10 bytes
+    char header[50];
+    file.read(header, sizeof(header));
+    const char *data = header, *end = header + file.gcount();
+    uint64_t value, length;
+    for (int i = 0; i < 4; ++i)
+        if (!read_varint(data, end, value))
+            return false;
+    if (!read_varint(data, end, length))
+        return false;
+    std::string payload(length, '\0');
+    file.clear(); // a record at the end of the file is shorter than the header buffer
+    file.seekg(found->second.offset + (data - header));
+    if (!file.read(payload.data(), length))
+        return false;
+    return decode(payload.data(), payload.data() + payload.size(), run);
+}
+
+uint32_t Ghost::position(uint64_t elapsed_ms) const
+{
+    return std::upper_bound(this->run.begin(), this->run.end(), elapsed_ms) - this->run.begin();
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#define TIMELINE_STORE_PATH "logs/timelines.db"
+#define TIMELINE_STORE_MAGIC "TTTL"
+#define TIMELINE_STORE_VERSION 1
+
+// Timelines file: the magic, a version byte, then one record per result, every number a varint:
+//   goal id, goal graphemes, typed graphemes, total milliseconds, payload bytes, payload
+// the payload holds the milliseconds between the typed graphemes (the first one counted from the first key), so a
+// grapheme typed within 127ms of the previous one takes a single byte
+
+/// @brief typing timeline of a test: milliseconds from the first key at which every grapheme of the goal was typed
+using timeline = std::vector<uint32_t>;
+
+/// @brief append-only file of delta encoded typing timelines, every result of a words goal gets one (see
+/// result_record::timeline), the fastest complete run of every goal is kept in an index built on the first lookup
+class TimelineStore
+{
+private:
+    struct best_run
+    {
+        uint32_t offset;
+        uint32_t total_ms;
+    };
+
+    std::string path;
+    int fd = -1;
+    bool indexed = false;
+    std::unordered_map<uint64_t, best_run> best; // by goal id
+
+    /// @brief map the file and index the fastest complete run of every goal from the record headers
+    void index();
+
+    /// @brief remember the run if it's complete and the fastest one of its goal
+    void consider(uint64_t goal_id, uint32_t goal_graphemes, uint32_t typed, uint32_t total_ms, uint32_t offset);
+
+public:
+    /// @param path timelines file, created with its directory on the first append
+    explicit TimelineStore(std::string path = TIMELINE_STORE_PATH);
+    ~TimelineStore();
+    TimelineStore(const TimelineStore &) = delete;
+    TimelineStore &operator=(const TimelineStore &) = delete;
+
+    /// @param goal test text
+    /// @return stable id of the goal (FNV-1a hash of the text)
+    static uint64_t goal_id(const std::string &goal);
+
+    /// @brief append delta encoded timeline to the output
+    /// @param run timeline of a test
+    /// @param output buffer the varints are appended to
+    static void encode(const timeline &run, std::string &output);
+
+    /// @brief decode timeline written by encode()
+    /// @param data first byte of the payload
+    /// @param end end of the payload
+    /// @param run replaced with the decoded timeline
+    /// @return false if the payload is damaged
+    static bool decode(const char *data, const char *end, timeline &run);
+
+    /// @brief append timeline of a test to the file
+    /// @param goal_id id of the goal (see goal_id())
+    /// @param goal_graphemes number of graphemes of the goal, runs with as many typed graphemes are complete
+    /// @param run timeline of the test
+    /// @return 1 + offset of the record in the file, 0 if it couldn't be written
+    uint32_t append(uint64_t goal_id, uint32_t goal_graphemes, const timeline &run);
+
+    /// @brief find the fastest complete run of a goal
+    /// @param goal_id id of the goal (see goal_id())
+    /// @param run replaced with the timeline of the run
+    /// @return false if the goal was never finished
+    bool fastest(uint64_t goal_id, timeline &run);
+
+    /// @return path of the timelines file
+    const std::string &filepath() const { return this->path; }
+};
+
+/// @brief replays a timeline against the clock of a running test
+class Ghost
+{
+private:
+    timeline run;
+
+public:
+    /// @return replayed timeline (filled with TimelineStore::fastest), empty for no ghost
+    timeline &track() { return this->run; }
+
+    /// @return true if there is a run to replay
+    bool active() const { return !this->run.empty(); }
+
+    void clear() { this->run.clear(); }
+
+    /// @param elapsed_ms milliseconds from the first key of the test
+    /// @return number of graphemes the ghost has typed by then
+    uint32_t position(uint64_t elapsed_ms) const;
+
+    /// @param position ghost position (see position())
+    /// @return milliseconds from the first key at which the ghost moves past given position, nothing once it's finished
+    std::optional<uint32_t> next_move_ms(uint32_t position) const
+    {
+        if (position >= this->run.size())
+            return std::nullopt;
+        return this->run[position];
+    }
+};
@@ -0,0 +1,60 @@
+#include "ttw.h"
+#include "corpus.h"
+
+#include <cstring>
+#include <fstream>
+#include <filesystem>
+
+std::string ttw_path_for(const std::string &txt_path)
+{
+    return std::filesystem::path(txt_path).replace_extension(TTW_EXTENSION).string();
+}
+
+bool ttw_compile(const std::string &txt_path, const std::string &ttw_path, std::string &error)
+{
+    Corpus corpus;
+    if (!corpus.load_text(txt_path))
+    {
+        error = "unable to open " + txt_path;
+        return false;
+    }
+    const std::vector<std::string_view> &words = corpus.words();
+
+    ttw_header header;
+    std::memcpy(header.magic, TTW_MAGIC, sizeof(header.magic));
+    header.version = TTW_VERSION;
+    header.flags = 0;
+    header.word_count = words.size();
+    header.blob_size = 0;
+
+    std::vector<uint32_t> offsets;
+    offsets.reserve(words.size() + 1);
+    for (const std::string_view &word : words)
+    {
+        if (header.blob_size + word.size() > UINT32_MAX)
+        {
+            error = txt_path + " is too big for the " TTW_EXTENSION " format";
+            return false;
+        }
+        offsets.push_back(header.blob_size);
+        header.blob_size += word.size();
+    }
+    offsets.push_back(header.blob_size);
+
+    std::ofstream out(ttw_path, std::ios::binary | std::ios::trunc);
+    if (!out)
+    {
+        error = "unable to create " + ttw_path;
+        return false;
+    }
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(offsets.data()), offsets.size() * sizeof(uint32_t));
+    for (const std::string_view &word : words)
+        out.write(word.data(), word.size());
+    if (!out)
+    {
+        error = "failed to write " + ttw_path;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+/*
+ * .ttw - precompiled word list, loaded without any parsing
+ *
+ * [ttw_header]
+ * [uint32_t offsets[word_count + 1]]         word i is blob[offsets[i], offsets[i + 1])
+ * [char blob[blob_size]]                     all words back to back, no separators
+ */
+
+#define TTW_MAGIC "TTW1"
+#define TTW_VERSION 1
+#define TTW_EXTENSION ".ttw"
+
+struct ttw_header
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t flags; // none defined yet, written as 0
+    uint32_t word_count;
+    uint64_t blob_size;
+};
+
+/// @param txt_path path to the text word list
+/// @return path of its precompiled counterpart (same name, .ttw extension)
+std::string ttw_path_for(const std::string &txt_path);
+
+/// @brief compile text word list (one word per line) into the .ttw format
+/// @param txt_path source word list
+/// @param ttw_path output file
+/// @param error filled with the reason of the failure
+/// @return true if the file was written
+bool ttw_compile(const std::string &txt_path, const std::string &ttw_path, std::string &error);
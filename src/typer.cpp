@@ -4,6 +4,7 @@ enum menu_item
 {
     START,
     OPTIONS,
+    STATS,
     QUIT,
     MENU_FIRST = START,
     MENU_LAST = QUIT
@@ -20,6 +21,9 @@ std::string get_option_name(menu_item item)
     case OPTIONS:
         option = "options";
         break;
+    case STATS:
+        option = "stats";
+        break;
     case QUIT:
         option = "quit";
         break;
@@ -34,9 +38,12 @@ enum settings_item
 {
     MODE,
     WORDS,
+    TIME_LIMIT,
     FILENAME,
     TRAILING_CURSOR,
     SHOW_STATS,
+    ADAPTIVE,
+    GHOST,
     RESTORE_DEFAULT,
     SAVE,
     EXIT,
@@ -55,6 +62,9 @@ std::string get_settings_name(settings_item item)
     case WORDS:
         option = "number of words";
         break;
+    case TIME_LIMIT:
+        option = "time limit";
+        break;
     case FILENAME:
         option = "filename";
         break;
@@ -64,6 +74,12 @@ std::string get_settings_name(settings_item item)
     case SHOW_STATS:
         option = "show stats when typing";
         break;
+    case ADAPTIVE:
+        option = "practice weak letters";
+        break;
+    case GHOST:
+        option = "race your best run (ghost)";
+        break;
     case RESTORE_DEFAULT:
         option = "restore settings to default";
         break;
@@ -80,58 +96,46 @@ std::string get_settings_name(settings_item item)
     return option_name.insert(2, option);
 }
 
-char get_input()
+char32_t lower_character(const key_event &key)
 {
-    char buf = 0;
-    struct termios old = {0};
-    if (tcgetattr(0, &old) < 0)
-        perror("tcsetattr()");
-    old.c_lflag &= ~ICANON;
-    old.c_lflag &= ~ECHO;
-    old.c_cc[VMIN] = 1;
-    old.c_cc[VTIME] = 0;
-    if (tcsetattr(0, TCSANOW, &old) < 0)
-        perror("tcsetattr ICANON");
-    if (read(0, &buf, 1) < 0)
-        perror("read()");
-    old.c_lflag |= ICANON;
-    old.c_lflag |= ECHO;
-    if (tcsetattr(0, TCSADRAIN, &old) < 0)
-        perror("tcsetattr ~ICANON");
-    return (buf);
+    if (key.type == key_type::NONE)
+        return GO_BACK_SHORTCUT;
+    if (key.type != key_type::CHARACTER)
+        return 0;
+    return key.codepoint < 128 ? tolower(key.codepoint) : key.codepoint;
 }
 
 bool yes_no_question(std::string question)
 {
-    char in;
+    char32_t in;
     std::cout << question << " (Y/N)\r";
-    std::cout.flush();
+    Screen::present();
     do
-        in = tolower(get_input());
-    while (in != 'y' && in != 'n');
+        in = lower_character(get_key());
+    while (in != 'y' && in != 'n' && in != GO_BACK_SHORTCUT);
     return in == 'y';
 }
 
-int16_t handle_up_down_arrow_key(char key)
+int16_t handle_up_down_arrow_key(const key_event &key)
 {
-    switch (key)
+    switch (key.type)
     {
-    case ARROW_UP:
+    case key_type::UP:
         return -1;
-    case ARROW_DOWN:
+    case key_type::DOWN:
         return 1;
     default:
         return 0;
     }
 }
 
-int16_t handle_left_right_arrow_key(char key)
+int16_t handle_left_right_arrow_key(const key_event &key)
 {
-    switch (key)
+    switch (key.type)
     {
-    case ARROW_LEFT:
+    case key_type::LEFT:
         return -1;
-    case ARROW_RIGHT:
+    case key_type::RIGHT:
         return 1;
     default:
         return 0;
@@ -147,30 +151,42 @@ void switch_menu_item(int16_t move, uint16_t &current_pos, const uint16_t lower_
 
 void clear_terminal()
 {
-    system("clear");
+    Screen::clear();
 }
 
 terminal_size get_terminal_size()
 {
-    struct winsize size;
-    ioctl(STDOUT_FILENO, TIOCGWINSZ, &size);
-    int width = size.ws_col;
-    int height = size.ws_row;
-    return {width, height};
+    return TerminalGeometry::size();
 }
 
-void print_centered(const std::string &text, const int desired_size, const char begin_end_char)
+std::string centered_line(const std::string &text, const int desired_size, const char begin_end_char)
 {
-    int left_padding = (get_terminal_size().width - desired_size) / 2;
-    std::cout << std::string(left_padding - 1, ' ') << begin_end_char << std::setw(desired_size) << text << begin_end_char << std::endl;
+    std::string line;
+    centered_line(line, text, desired_size, begin_end_char);
+    return line;
+}
+
+void centered_line(std::string &output, const std::string &text, const int desired_size, const char begin_end_char)
+{
+    int left_padding = std::max((get_terminal_size().width - desired_size) / 2, 1);
+    output.assign(left_padding - 1, ' ');
+    output += begin_end_char;
+    if (text.size() < (std::size_t)desired_size)
+        output.append(desired_size - text.size(), ' ');
+    output += text;
+    output += begin_end_char;
 }
 
 Typer::Typer() : Typer(DEFAULT_CONFIG_FILENAME) {}
 
-Typer::Typer(std::string config_filename) : config_filename(config_filename), logger("typer.log", "typer.cpp"), results_logger("results.log", "typer.cpp")
+Typer::Typer(std::string config_filename) : config_filename(config_filename), logger("typer.log", "typer.cpp")
 {
     this->load_settings();
-    Generator::init(this->settings["words_filename"]);
+    this->stats.load(this->results_store);
+    if (this->settings.seed)
+        Generator::seed(*this->settings.seed);
+    if (!this->streaming())
+        Generator::init(this->settings.words_filename);
 }
 
 void Typer::select_menu()
@@ -179,7 +195,7 @@ void Typer::select_menu()
     const uint16_t row_begin = 6, row_separate = 2;
     uint16_t current_row = row_begin;
     int16_t move = 0;
-    char key;
+    key_event key;
 
     clear_terminal();
     while (true)
@@ -199,25 +215,25 @@ void Typer::select_menu()
             std::cout << option_name << std::endl;
         }
         terminal_jump_to(current_row, 2);
-        std::cout.flush();
-        key = get_input();
+        Screen::present();
+        key = get_key();
         move = handle_up_down_arrow_key(key) * row_separate;
-        if (key == ENTER)
+        if (key.type == key_type::ENTER)
         {
             switch ((current_row - row_begin) / row_separate)
             {
             case START:
-                if (this->settings["mode"] == CLASSIC_MODE)
-                    this->reset(Generator::generate(std::stoi(this->settings["no_words"])));
-                else if (this->settings["mode"] == TEXT_MODE)
-                    this->reset(Generator::get_text(this->settings["words_filename"]));
-                else
-                    return;
-                this->start_test();
+                if (this->renew_goal())
+                    this->start_test();
+                if (this->racing())
+                    this->race.leave(); // back in the menu, the next race doesn't wait for this racer
                 break;
             case OPTIONS:
                 this->change_settings();
                 break;
+            case STATS:
+                this->display_history();
+                break;
             case QUIT:
                 if (this->settings_changed)
                 {
@@ -231,7 +247,7 @@ void Typer::select_menu()
             }
             clear_terminal();
         }
-        else if (key == GO_BACK_SHORTCUT)
+        else if (key.is(GO_BACK_SHORTCUT) || key.type == key_type::NONE)
         {
             if (this->settings_changed)
             {
@@ -248,90 +264,174 @@ void Typer::select_menu()
 
 void Typer::start_test()
 {
-    char in;
-    auto begin = std::chrono::steady_clock::now();
-    std::string debug = "";
-    bool started = false;
+    session_state state = session_state::TEST;
+    while (state != session_state::DONE)
+    {
+        switch (state)
+        {
+        case session_state::TEST:
+            this->run_test();
+            state = session_state::RESULT;
+            break;
+        case session_state::RESULT:
+            state = this->finish_test();
+            break;
+        case session_state::AGAIN:
+            this->reset();
+            state = session_state::TEST;
+            break;
+        case session_state::NEXT:
+            state = this->renew_goal() ? session_state::TEST : session_state::DONE;
+            break;
+        default:
+            state = session_state::DONE;
+            break;
+        }
+    }
+}
+
+void Typer::run_test()
+{
     terminal_size term_size = get_terminal_size(), previous_term_size;
 
     clear_terminal();
-    this->logger << "test with " + std::to_string(this->get_words_amount()) + " words and " + std::to_string(this->get_characters_amount()) + " characters started";
-    while (this->results.user_score != this->results.goal.length())
+    this->renderer.invalidate();
+    if (this->layout_ready)
+    {
+        this->renderer.draw_layout(this->prepared_layout, term_size.width);
+        this->layout_ready = false;
+    }
+    this->follow_text(term_size.width);
+    this->load_ghost();
+    this->ghost_marks[0] = 0;
+    if (this->racing())
+    {
+        this->race.send_progress(this->engine.score());
+        this->logger << "race with " + std::to_string(this->race.racers()) + " other racers started";
+    }
+    else if (this->streaming())
+        this->logger << "text test with " + this->settings.words_filename + " started";
+    else if (this->timed())
+        this->logger << std::to_string(this->settings.time_limit) + "s timed test with " + this->settings.words_filename + " started";
+    else
+        this->logger << "test with " + std::to_string(this->engine.words_amount()) + " words and " + std::to_string(this->engine.characters_amount()) + " characters started" +
+                            (this->ghost.active() ? " against a " + this->format(this->ghost.track().back() / 1000.f, 4) + "s ghost" : "");
+    while (!this->engine.finished())
     {
         previous_term_size = term_size;
         term_size = get_terminal_size();
         if (previous_term_size != term_size)
-            clear_terminal();
-        if (this->settings["show_stats"] == "1")
-            this->results.time = since(begin).count();
-        this->display_progress();
-        if (this->settings["trailing_cursor"] == "1")
-        {
-            terminal_jump_to(((this->results.user_score + 1) / term_size.width) + 1, (this->results.user_score + 1) % term_size.width);
-            std::cout.flush();
-        }
-        in = get_input();
-        if (in == ESCAPE) break;
-        if (!started)
         {
-            started = true;
-            begin = std::chrono::steady_clock::now();
+            clear_terminal();
+            this->renderer.invalidate();
+            this->follow_text(term_size.width);
         }
-        if (in == this->results.goal.at(this->results.user_score))
-            (this->results.user_score)++;
-        debug += in;
-        (this->results.input_count)++;
+        this->update_ghost();
+        this->display_progress(term_size.width);
+        const terminal_event event = this->events.next();
+        if (event.type == event_type::TICK)
+            this->engine.update_time(event.timestamp_ns);
+        if (event.type == event_type::SOCKET)
+            this->receive_race();
+        if (event.type != event_type::KEY)
+            continue;
+        const key_event &key = event.key;
+        if (key.type == key_type::ESCAPE || key.type == key_type::NONE) break;
+        if (key.type != key_type::CHARACTER) continue;
+        //? the stats keep running while the user pauses and a timed test ends on time, the timer ticks only from
+        //? the first key to the end of the test
+        if (!this->engine.is_started() && (this->settings.show_stats || this->timed()))
+            this->events.set_ticking(true);
+        if (this->engine.type(event.timestamp_ns, key.codepoint) == key_outcome::CORRECT && this->racing())
+            this->race.send_progress(this->engine.score());
     }
-    this->results.time = since(begin).count();
+    this->events.set_ticking(false);
+    this->events.set_alarm(0);
+    if (!this->engine.finished())
+        this->engine.update_time(now_ns());
+}
+
+session_state Typer::finish_test()
+{
+    char32_t in;
     this->display_finish();
 
-    std::stringstream ss;
-    ss << std::setw(10) << std::left << this->format(this->get_accuracy() * 100, 4) + "%"
-       << std::setw(10) << std::left << this->format(this->results.time / 1000.f, 4) + "s"
-       << std::setw(10) << std::left << this->format(this->get_WPM(), 4) + "WPM";
-    this->results_logger << ss.str();
+    this->save_result();
+    this->save_replay();
+    if (!this->streaming())
+        Generator::learn(this->engine.keystrokes());
+    this->prepare_next_test();
+    this->log_keystroke_summary();
 
-    //? call for next user action 
-    terminal_jump_to(12, 0);
+    //? call for next user action
+    terminal_jump_to(STATS_PARK_ROW + 1, 0);
     std::cout << "What do you want to do next? [click first letter]"
               << " (Again/Restart/Quit)\r";
-    std::cout.flush();
+    Screen::present();
     do
-        in = tolower(get_input());
-    while (in != 'a' && in != 'r' && in != 'q');
-    if (in == 'q') return;
-    else if (in == 'a') this->reset();
-    else
-    {
-        if (this->settings["mode"] == CLASSIC_MODE)
-            this->reset(Generator::generate(std::stoi(this->settings["no_words"])));
-        else if (this->settings["mode"] == TEXT_MODE)
-            this->reset(Generator::get_text(this->settings["words_filename"]));
-    }
-    this->start_test();
+        in = lower_character(get_key());
+    while (in != 'a' && in != 'r' && in != GO_BACK_SHORTCUT);
+    if (in == 'r')
+        return session_state::NEXT;
+    this->await_next_test(); // the prepared test isn't needed, the Generator is free again once it's done
+    return in == 'a' ? session_state::AGAIN : session_state::DONE;
+}
+
+void Typer::reset()
+{
+    this->engine.reset();
+    this->logger << "goal reset";
 }
 
-void Typer::reset(std::string &&goal)
+bool Typer::renew_goal()
 {
-    if (goal == "")
+    this->engine.set_time_limit(this->timed() && !this->racing() ? this->settings.time_limit * 1000 : 0);
+    if (this->racing())
+        return this->next_race();
+    if (this->streaming())
     {
-        this->results = {0, 0, 0, this->results.goal};
-        this->logger << "goal reset";
+        if (!this->engine.open_text(this->settings.words_filename))
+        {
+            this->logger << "=ERROR= Unable to open file " + this->settings.words_filename;
+            return false;
+        }
+    }
+    else if (Generator::size() == 0)
+    {
+        //? a test with an empty goal would finish at once and save a 0 WPM result
+        this->logger << "=ERROR= No words loaded from " + this->settings.words_filename;
+        return false;
+    }
+    else if (this->timed())
+    {
+        //? words are generated in batches whenever the lines ahead of the cursor need more text, so the next batch
+        //? is there before the cursor reaches the end of the viewport and the stream keeps only the lines around it
+        const bool adaptive = this->settings.adaptive;
+        this->engine.open_words([adaptive](std::string &chunk)
+                                { return Generator::generate_batch(WORD_BATCH_SIZE, chunk, adaptive); });
+    }
+    else if (this->await_next_test())
+    {
+        this->engine.swap_goal(this->prepared_goal, this->prepared_graphemes);
+        this->layout_ready = true;
     }
     else
     {
-        this->results = {0, 0, 0, std::move(goal)};
-        this->logger << "new goal set";
+        this->next_goal(this->prepared_goal);
+        this->engine.set_goal(this->prepared_goal);
     }
+    this->logger << "new goal set";
+    return true;
 }
 
 void Typer::change_settings()
 {
-    std::string option_name, previous_mode;
+    std::string option_name;
+    typer_mode previous_mode;
     const uint16_t row_begin = 6, row_separate = 1;
     uint16_t current_row = row_begin;
     int16_t move = 0;
-    char key;
+    key_event key;
 
     clear_terminal();
     while (true)
@@ -351,28 +451,33 @@ void Typer::change_settings()
             std::cout << option_name << std::endl;
         }
         terminal_jump_to(current_row, 2);
-        std::cout.flush();
-        key = get_input();
+        Screen::present();
+        key = get_key();
         move = handle_up_down_arrow_key(key) * row_separate;
-        if (key == ENTER)
+        if (key.type == key_type::ENTER)
         {
             switch ((current_row - row_begin) / row_separate)
             {
             case MODE:
-                previous_mode = this->settings["mode"];
-                this->change_switch_option("mode", {{"CLASSIC", CLASSIC_MODE}, {"TEXTS", TEXT_MODE}});
-                if (previous_mode != this->settings["mode"])
+                previous_mode = this->settings.mode;
+                this->change_switch_option("mode", {{"CLASSIC", CLASSIC_MODE}, {"TEXTS", TEXT_MODE}, {"TIMED", TIMED_MODE}});
+                if (previous_mode != this->settings.mode)
                 {
-                    std::string path = (this->settings["mode"] == CLASSIC_MODE ? "words" : "texts");
-                    this->settings["words_filename"] = path + "/" + get_first_file(path);
-                    this->logger << "filename changed to: < " + this->settings["words_filename"] + " >";
+                    std::string path = (this->streaming() ? "texts" : "words");
+                    this->settings.words_filename = path + "/" + get_first_file(path);
+                    if (!this->streaming())
+                        Generator::change_file(this->settings.words_filename);
+                    this->logger << "filename changed to: < " + this->settings.words_filename + " >";
                 }
                 break;
             case WORDS:
                 this->change_words_amount();
                 break;
+            case TIME_LIMIT:
+                this->change_time_limit();
+                break;
             case FILENAME:
-                this->change_words_filename(this->settings["mode"] == CLASSIC_MODE ? "words" : "texts");
+                this->change_words_filename(this->streaming() ? "texts" : "words");
                 break;
             case TRAILING_CURSOR:
                 this->change_switch_option("trailing_cursor", {{"ON", "1"}, {"OFF", "0"}});
@@ -380,6 +485,12 @@ void Typer::change_settings()
             case SHOW_STATS:
                 this->change_switch_option("show_stats", {{"ON", "1"}, {"OFF", "0"}});
                 break;
+            case ADAPTIVE:
+                this->change_switch_option("adaptive", {{"ON", "1"}, {"OFF", "0"}});
+                break;
+            case GHOST:
+                this->change_switch_option("ghost", {{"ON", "1"}, {"OFF", "0"}});
+                break;
             case RESTORE_DEFAULT:
                 this->load_default_settings();
                 break;
@@ -398,7 +509,7 @@ void Typer::change_settings()
             }
             clear_terminal();
         }
-        else if (key == GO_BACK_SHORTCUT)
+        else if (key.is(GO_BACK_SHORTCUT) || key.type == key_type::NONE)
         {
             if (this->settings_changed)
             {
@@ -415,6 +526,57 @@ void Typer::change_settings()
     }
 }
 
+void Typer::display_history()
+{
+    const stats_aggregate &history = this->stats.get();
+    auto best_line = [this](const std::string &name, const personal_best &best)
+    {
+        std::stringstream ss;
+        ss << "  " << std::setw(18) << std::left << name;
+        if (best.wpm > 0)
+            ss << std::setw(12) << this->format(best.wpm, 4) + " WPM" << this->format(best.accuracy * 100, 4) << "%";
+        else
+            ss << "-";
+        return ss.str();
+    };
+
+    clear_terminal();
+    terminal_jump_to(0, 0);
+    std::cout << DESCRIPTION_COLOR << "Your typing statistics.\n"
+              << "Press any key to go back.\n"
+              << RESET << "\n";
+    if (history.tests == 0)
+        std::cout << "No tests finished yet.\n";
+    else
+    {
+        const float trend = this->stats.accuracy_trend() * 100;
+        std::cout << STATS_COLOR << "Tests finished:     " << RESET << history.tests << "\n"
+                  << STATS_COLOR << "Average WPM:        " << RESET << this->format(history.wpm_sum / history.tests, 4) << "\n"
+                  << STATS_COLOR << "Rolling WPM:        " << RESET << this->format(this->stats.rolling_wpm(), 4) << " (last " << history.recent_count << " tests)\n"
+                  << STATS_COLOR << "Rolling accuracy:   " << RESET << this->format(this->stats.rolling_accuracy() * 100, 4) << "% ("
+                  << (trend >= 0 ? "+" : "") << this->format(trend, 3) << "% trend)\n"
+                  << STATS_COLOR << "Recent WPM:         " << RESET << this->stats.sparkline() << "\n\n"
+                  << STATS_COLOR << "Personal bests:" << RESET << "\n";
+        for (uint32_t i = 0; i < STATS_WORD_SLOTS; ++i)
+            std::cout << best_line("classic " + std::to_string((i + 1) * STATS_WORD_STEP) + " words", history.classic_best[i]) << "\n";
+        std::cout << best_line("classic other", history.classic_other_best) << "\n";
+        for (uint32_t i = 0; i < STATS_TIME_SLOTS; ++i)
+            std::cout << best_line("timed " + std::to_string(TIME_LIMITS[i]) + "s", history.timed_best[i]) << "\n";
+        std::cout << best_line("texts", history.text_best) << "\n";
+    }
+    Screen::present();
+    get_key();
+    this->logger << "statistics displayed";
+}
+
+void Typer::change_time_limit()
+{
+    std::vector<option> limits;
+    for (uint32_t limit : TIME_LIMITS)
+        limits.push_back({std::to_string(limit) + "s", std::to_string(limit)});
+    this->change_switch_option("time_limit", limits);
+}
+
 void Typer::change_words_amount()
 {
     std::stringstream ss;
@@ -432,7 +594,7 @@ void Typer::change_words_amount()
     const std::string element_before_option = "-> ", words_setting_name = "no_words";
     uint16_t current_row = row_begin;
     int16_t move = 0;
-    char key;
+    key_event key;
 
     auto is_hovered = [&current_row, &row_begin](uint32_t option_number)
     { return (row_begin + option_number * row_separate) == current_row; };
@@ -456,17 +618,17 @@ void Typer::change_words_amount()
             }
         }
         terminal_jump_to(current_row, 2);
-        std::cout.flush();
-        key = get_input();
+        Screen::present();
+        key = get_key();
         move = handle_up_down_arrow_key(key) * row_separate;
-        if (key == ENTER)
+        if (key.type == key_type::ENTER)
         {
-            this->settings[words_setting_name] = std::to_string(value_jump * (((current_row - row_begin) / row_separate) + 1));
+            this->settings.no_words = value_jump * (((current_row - row_begin) / row_separate) + 1);
             this->settings_changed = true;
-            this->logger << "words amount changed to: < " + this->settings[words_setting_name] + " >";
+            this->logger << "words amount changed to: < " + std::to_string(this->settings.no_words) + " >";
             return;
         }
-        else if (key == GO_BACK_SHORTCUT)
+        else if (key.is(GO_BACK_SHORTCUT) || key.type == key_type::NONE)
             return;
         else
             switch_menu_item(move, current_row, row_begin, row_begin + (no_options - 1) * row_separate);
@@ -488,7 +650,7 @@ void Typer::change_words_filename(const std::string &path)
     const std::string element_before_option = "->> ", filename_setting_name = "words_filename";
     uint16_t current_row = row_begin;
     int16_t move = 0;
-    char key;
+    key_event key;
     auto files = this->get_filenames_vector(path);
 
     auto is_hovered = [&current_row, &row_begin](uint32_t option_number)
@@ -512,26 +674,49 @@ void Typer::change_words_filename(const std::string &path)
             }
         }
         terminal_jump_to(current_row, 2);
-        std::cout.flush();
-        key = get_input();
+        Screen::present();
+        key = get_key();
         move = handle_up_down_arrow_key(key) * row_separate;
-        if (key == ENTER)
+        if (key.type == key_type::ENTER)
         {
-            this->settings[filename_setting_name] = path + "/" + files.at(((current_row - row_begin) / row_separate));
-            Generator::change_file(this->settings[filename_setting_name]);
+            this->settings.words_filename = path + "/" + files.at(((current_row - row_begin) / row_separate));
+            if (!this->streaming())
+                Generator::change_file(this->settings.words_filename);
             this->settings_changed = true;
-            this->logger << "filename changed to: < " + this->settings[filename_setting_name] + " >";
+            this->logger << "filename changed to: < " + this->settings.words_filename + " >";
             return;
         }
-        else if (key == GO_BACK_SHORTCUT)
+        else if (key.is(GO_BACK_SHORTCUT) || key.type == key_type::NONE)
             return;
         else
             switch_menu_item(move, current_row, row_begin, row_begin + (files.size() - 1) * row_separate);
     }
 }
 
+bool Typer::join_race(const std::string &socket_path)
+{
+    std::string error;
+    if (!this->race.connect(socket_path, error))
+    {
+        std::cerr << error << std::endl;
+        this->logger << "=ERROR= " + error;
+        return false;
+    }
+    //? races are typed in classic mode, the words file is still needed for the goals after a lost server
+    if (this->settings.mode != typer_mode::CLASSIC)
+    {
+        this->settings.mode = typer_mode::CLASSIC;
+        this->settings.words_filename = "words/" + get_first_file("words");
+        Generator::change_file(this->settings.words_filename);
+    }
+    this->events.watch(this->race.socket());
+    this->logger << "joined race at " + socket_path;
+    return true;
+}
+
 void Typer::run()
 {
+    TerminalSession session;
     this->logger << "app run";
     this->select_menu();
 }
\ No newline at end of file
@@ -2,79 +2,40 @@
 
 #include "generator.h"
 #include "logger.h"
+#include "race.h"
+#include "terminal.h"
+#include "renderer.h"
+#include "replay.h"
+#include "settings.h"
+#include "keystrokes.h"
+#include "results_store.h"
+#include "stats.h"
+#include "test_engine.h"
+#include "timeline.h"
+#include "utf8.h"
 
 #include <iostream>
 #include <unistd.h>
-#include <termios.h>
 #include <chrono>
 #include <iomanip>
 #include <math.h>
 #include <cctype>
-#include <map>
 #include <filesystem>
-#include <sys/ioctl.h>
+#include <future>
 
-#define terminal_jump_to(row, col) printf("\033[%d;%dH", row, col);
-#define TEXT_START_ROW 0
-#define TEXT_START_COL 0
-#define STATS_START_ROW 5
-#define STATS_START_COL 0
+#define terminal_jump_to(row, col) std::cout << "\033[" << (row) << ";" << (col) << "H";
 
 #define GO_BACK_SHORTCUT 113 // q
 
-#define ENTER 10
-#define ESCAPE 27
-#define ARROW_UP 65
-#define ARROW_DOWN 66
-#define ARROW_RIGHT 67
-#define ARROW_LEFT 68
-
-#define INITIAL_COLOR "\033[0m"
-#define CORRECT_COLOR "\033[1;32m"
-#define FINISHED_COLOR "\033[1;34m"
-#define STATS_COLOR "\033[1;36m"
-#define DESCRIPTION_COLOR "\033[1;34m"
-#define OPTION_CONFIG_COLOR "\033[1;3;4;35m"
-#define OPTION_PICKED_COLOR "\033[1;4;6;32m"
-#define RESET "\033[0m"
-
-#define DEFAULT_CONFIG_FILENAME "config.txt"
-
-#define CLASSIC_MODE "0"
-#define TEXT_MODE "1"
-
 struct option
 {
     std::string name;
     std::string value;
 };
 
-struct terminal_size
-{
-    int width, height;
-
-    bool operator==(const terminal_size &other) const
-    {
-        return width == other.width && height == other.height;
-    }
-
-    bool operator!=(const terminal_size &other) const
-    {
-        return !(*this == other);
-    }
-};
-
-struct test_result
-{
-    int64_t time;
-    uint32_t user_score;
-    uint32_t input_count;
-    std::string goal;
-};
-
-/// @brief get one char input from stdin without the need of pressing enter
-/// @return character clicked
-char get_input();
+/// @param key key pressed by user
+/// @return lowercase character typed, GO_BACK_SHORTCUT when the input is closed, 0 for other keys
+char32_t lower_character(const key_event &key);
 
 /// @brief ask user a yes/no question
 /// @param question question to be asked
@@ -84,12 +45,12 @@ bool yes_no_question(std::string question);
 /// @brief translate arrow key pressed to movement value
 /// @param key key pressed by user
 /// @return 1 for arrow down, -1 for arrow up, else 0
-int16_t handle_up_down_arrow_key(char key);
+int16_t handle_up_down_arrow_key(const key_event &key);
 
 /// @brief translate arrow key pressed to movement value
 /// @param key key pressed by user
 /// @return 1 for arrow right, -1 for arrow left, else 0
-int16_t handle_left_right_arrow_key(char key);
+int16_t handle_left_right_arrow_key(const key_event &key);
 
 /// @brief safely change the value of current position without exiting the boundaries in one direction (horizontally/vertically)
 /// @param move 1 for up/right, -1 for down/left movement
@@ -98,21 +59,55 @@ int16_t handle_left_right_arrow_key(char key);
 /// @param upper_boundary biggest possible value
 void switch_menu_item(int16_t move, uint16_t &current_pos, const uint16_t lower_boundary, const uint16_t upper_boundary);
 
-/// @brief clear terminal output
+/// @brief clear terminal output (sent with the next frame)
 void clear_terminal();
 
+/// @return cached terminal size (see TerminalGeometry)
 terminal_size get_terminal_size();
 
-void print_centered(const std::string &text, const int desired_size = 30, const char begin_end_char = '|');
+/// @brief frame text of given width and center it in the terminal
+/// @param text framed text (right aligned within the frame)
+/// @param desired_size width of the frame content
+/// @param begin_end_char frame character
+/// @return line ready to be printed (no newline)
+std::string centered_line(const std::string &text, const int desired_size = 30, const char begin_end_char = '|');
+
+/// @brief same as centered_line(text, ...), writes into given string reusing its buffer
+/// @param output replaced with the line ready to be printed (no newline)
+void centered_line(std::string &output, const std::string &text, const int desired_size = 30, const char begin_end_char = '|');
+
+/// @brief steps of a typing session started from the main menu
+enum class session_state
+{
+    TEST,   // typing the goal
+    RESULT, // results shown, waiting for the next action
+    AGAIN,  // same goal once more
+    NEXT,   // new goal
+    DONE    // back to the menu
+};
 
 class Typer
 {
 private:
-    test_result results;
     std::string config_filename;
-    std::map<std::string, std::string> settings;
+    typer_settings settings;
     bool settings_changed = false;
-    Logger logger, results_logger;
+    Logger logger;
+    ResultsStore results_store;
+    StatsAggregator stats;
+    ProgressRenderer renderer;
+    TestEngine engine;
+    EventLoop events = EventLoop(STATS_REFRESH_HZ);
+    RaceClient race;
+    TimelineStore timelines;
+    Ghost ghost;
+    std::vector<uint32_t> ghost_marks = std::vector<uint32_t>(1); // ghost position drawn with draw_marks
+    std::vector<std::string> stats_lines = std::vector<std::string>(6);
+    std::string stats_text;
+    std::future<void> next_test;
+    std::string prepared_goal, prepared_layout;
+    GraphemeIndex prepared_graphemes;
+    bool layout_ready = false;
 
     /// @param start relative time point
     /// @return time from the start point to now in milliseconds
@@ -125,15 +120,6 @@ private:
         return std::chrono::duration_cast<result_t>(clock_t::now() - start);
     }
 
-    /// @brief split target goal of current test into two parts (already typed and to be typed)
-    /// @param left already typed by user
-    /// @param right to be typed by user
-    void split_goal_to(std::string &left, std::string &right)
-    {
-        left = this->results.goal.substr(0, this->results.user_score);
-        right = this->results.goal.substr(this->results.user_score);
-    }
-
     /// @brief format given float number to a given precission
     /// @param f number to be formatted
     /// @param digits number of digits to be rounded to
@@ -146,100 +132,278 @@ private:
         return ss.str();
     }
 
-    /// @return current test accuracy
-    float get_accuracy() { return this->results.input_count == 0 ? 0.f : (float)this->results.user_score / this->results.input_count; }
+    /// @return true if the test goal is a text streamed from a file (text mode), else the goal is generated words
+    bool streaming() const { return this->settings.mode == typer_mode::TEXT; }
+
+    /// @return true if the test goal is an endless stream of generated words typed until the time limit (timed mode)
+    bool timed() const { return this->settings.mode == typer_mode::TIMED; }
+
+    /// @return true while connected to a race server, the goals come from the server then
+    bool racing() const { return this->race.connected(); }
+
+    /// @return true if the fastest previous run of the goal is replayed as a ghost (words goals typed alone)
+    bool ghost_mode() const { return this->settings.ghost && !this->streaming() && !this->timed() && !this->racing(); }
+
+    /// @brief load the fastest previous run of the current goal as the ghost (none if the goal was never finished)
+    void load_ghost()
+    {
+        this->ghost.clear();
+        if (!this->ghost_mode() || !this->timelines.fastest(TimelineStore::goal_id(this->engine.goal()), this->ghost.track()))
+            return;
+        //? a run of another goal with the same id can't be replayed, it wouldn't end with the goal
+        if (this->ghost.track().size() != this->engine.characters_amount())
+            this->ghost.clear();
+    }
+
+    /// @brief move the ghost to where its run was at this moment of the test and set the event loop alarm to the time
+    /// of its next move, so the ghost is redrawn exactly when it moves and nothing runs in between
+    void update_ghost()
+    {
+        if (!this->ghost.active() || !this->engine.is_started())
+            return;
+        const uint64_t begin_ns = this->engine.begin_time_ns();
+        this->ghost_marks[0] = this->ghost.position((now_ns() - begin_ns) / 1000000);
+        const std::optional<uint32_t> next_ms = this->ghost.next_move_ms(this->ghost_marks[0]);
+        this->events.set_alarm(next_ms ? begin_ns + *next_ms * 1000000ull : 0);
+    }
+
+    /// @brief wrap the streamed text to given width and keep the lines around the typing position (see VIEWPORT_ROWS)
+    /// @param width current terminal width
+    void follow_text(int width)
+    {
+        this->engine.set_view(width, VIEWPORT_ROWS_BEHIND, VIEWPORT_ROWS - VIEWPORT_ROWS_BEHIND - 1);
+    }
+
+    /// @brief generate new word goal for the current settings
+    /// @param goal replaced with the new goal, its buffer is reused
+    void next_goal(std::string &goal)
+    {
+        if (this->settings.adaptive)
+            Generator::generate_adaptive(this->settings.no_words, goal);
+        else
+            Generator::generate(this->settings.no_words, goal);
+    }
+
+    /// @brief generate the goal of the next test and lay out its first frame in the background (while the results are shown)
+    void prepare_next_test()
+    {
+        if (this->streaming() || this->timed() || this->racing())
+            return;
+        this->next_test = std::async(std::launch::async, [this]
+                                     {
+                                         this->next_goal(this->prepared_goal);
+                                         this->prepared_graphemes.build(this->prepared_goal);
+                                         ProgressRenderer::layout_goal(this->prepared_goal, this->prepared_layout); });
+    }
 
-    /// @return current test time in seconds
-    float get_time_s() { return this->results.time / 1000.f; }
+    /// @brief wait until the background preparation (if any) is finished
+    /// @return true if prepared_goal, prepared_graphemes and prepared_layout hold the next test
+    bool await_next_test()
+    {
+        if (!this->next_test.valid())
+            return false;
+        this->next_test.get();
+        return true;
+    }
 
-    /// @return current test WPM
-    float get_WPM() { return (this->results.user_score / 5.f) / (this->results.time / 60000.f); }
+    /// @brief append result of the finished test to the results store
+    void save_result()
+    {
+        result_record record = {};
+        record.timestamp = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+        record.corpus_id = ResultsStore::corpus_id(this->settings.words_filename);
+        record.word_count = std::min<uint64_t>(this->engine.words_amount(), UINT16_MAX);
+        record.mode = static_cast<uint8_t>(this->settings.mode);
+        record.flags = this->engine.finished() ? 0 : RESULT_FLAG_INTERRUPTED;
+        record.accuracy = this->engine.accuracy();
+        record.time_s = this->engine.time_s();
+        record.wpm = this->engine.wpm();
+        if (!this->engine.is_streaming())
+        {
+            record.timeline = this->timelines.append(TimelineStore::goal_id(this->engine.goal()), this->engine.characters_amount(), this->engine.timeline());
+            if (record.timeline == 0)
+                this->logger << "=ERROR= Unable to save timeline to " + this->timelines.filepath();
+        }
+        if (this->results_store.append(record))
+        {
+            this->stats.add(record);
+            if (!this->stats.save())
+                this->logger << "=ERROR= Unable to save statistics";
+        }
+        else
+            this->logger << "=ERROR= Unable to save result to " + this->results_store.filepath();
+        this->logger << "result: " + this->format(record.accuracy * 100, 4) + "% " + this->format(record.time_s, 4) + "s " + this->format(record.wpm, 4) + "WPM";
+    }
 
-    /// @return current test characters amount
-    uint16_t get_characters_amount() { return this->results.goal.length(); }
+    /// @brief save keystrokes of the finished test (and the goal in classic mode) so the test can be replayed headless
+    void save_replay()
+    {
+        if (!Replayer::save(LAST_TEST_KEYS_PATH, this->engine.keystrokes()))
+            this->logger << "=ERROR= Unable to save keystrokes to " LAST_TEST_KEYS_PATH;
+        if (this->engine.is_streaming())
+            return;
+        std::ofstream goal_file(LAST_TEST_GOAL_PATH);
+        if (!(goal_file << this->engine.goal() << std::endl))
+            this->logger << "=ERROR= Unable to save goal to " LAST_TEST_GOAL_PATH;
+    }
 
-    /// @return current test word count
-    uint16_t get_words_amount()
+    /// @brief log typing analysis of the finished test (latencies, burst WPM, weakest character)
+    void log_keystroke_summary()
     {
-        std::stringstream ss(this->results.goal);
-        std::string word;
-        uint16_t count = 0;
-        while (ss >> word)
-            ++count;
-        return count;
+        const keystroke_summary summary = this->engine.keystrokes().summarize();
+        std::string histogram;
+        for (std::size_t i = 0; i < summary.latency_histogram.size(); ++i)
+            if (summary.latency_histogram[i] != 0)
+                histogram += " " + std::to_string(i * LATENCY_BUCKET_MS) + "ms:" + std::to_string(summary.latency_histogram[i]);
+        std::string weakest = "none";
+        if (char32_t c = summary.weakest_character())
+        {
+            weakest = "'";
+            append_utf8(weakest, c);
+            weakest += "' " + this->format(summary.error_rate(c) * 100, 3) + "% errors";
+        }
+        this->logger << "keystrokes: " + std::to_string(summary.keystrokes) + " (" + std::to_string(summary.errors) + " wrong, " + std::to_string(summary.dropped) + " not recorded)" +
+                            ", mean latency " + this->format(summary.mean_latency_ms, 4) + "ms, burst " + this->format(summary.burst_wpm, 4) + "WPM, weakest " + weakest;
+        this->logger << "latency histogram:" + histogram;
     }
 
-    /// @brief display test stats (accuracy, time, WPM)
+    /// @brief display test stats (accuracy, time, WPM), the box lines are built into reused buffers
     void display_stats()
     {
         const int desired_width = 30;
-        const std::string bottom_top_line(desired_width, '-');
-        terminal_jump_to(STATS_START_ROW, STATS_START_COL);
-        std::cout << STATS_COLOR;
-        print_centered(bottom_top_line, desired_width, '+');
-        print_centered("Accuracy: " + this->format(this->get_accuracy() * 100, 4) + "% ", desired_width);
-        print_centered("Elapsed = " + this->format(this->results.time / 1000.f, 4) + "s ", desired_width);
-        print_centered("WPM = " + this->format(this->get_WPM(), 4) + " ", desired_width);
-        print_centered("Characters:  " + std::to_string(this->results.user_score) + "/" + std::to_string(this->results.goal.length()) + " ", desired_width);
-        print_centered(bottom_top_line, desired_width, '+');
-        std::cout << RESET << "\n";
+        std::string &text = this->stats_text;
+        text.assign(desired_width, '-');
+        centered_line(this->stats_lines[0], text, desired_width, '+');
+        centered_line(this->stats_lines[5], text, desired_width, '+');
+        text.assign("Accuracy: ").append(this->format(this->engine.accuracy() * 100, 4)).append("% ");
+        centered_line(this->stats_lines[1], text, desired_width);
+        text.assign("Elapsed = ").append(this->format(this->engine.time_s(), 4));
+        if (this->engine.time_limit() != 0)
+            text.append("/").append(std::to_string(this->engine.time_limit() / 1000));
+        text.append("s ");
+        centered_line(this->stats_lines[2], text, desired_width);
+        text.assign("WPM = ").append(this->format(this->engine.wpm(), 4)).append(" ");
+        centered_line(this->stats_lines[3], text, desired_width);
+        text.assign("Characters:  ").append(std::to_string(this->engine.score()));
+        if (this->timed())
+            text.append(" ");
+        else if (this->engine.is_streaming())
+            text.append(this->engine.stream().length_known() ? "/" : "/~").append(std::to_string(this->engine.stream().length_hint())).append(" ");
+        else
+            text.append("/").append(std::to_string(this->engine.characters_amount())).append(" ");
+        centered_line(this->stats_lines[4], text, desired_width);
+        this->renderer.draw_stats(this->stats_lines);
     }
 
-    /// @brief display test progress (already typed and to be typed)
-    void display_progress()
+    /// @brief display test progress (already typed and to be typed), only the difference to the previous frame is drawn
+    /// @param width current terminal width
+    void display_progress(int width)
     {
-        std::string left, right;
-        split_goal_to(left, right);
-        terminal_jump_to(TEXT_START_ROW, TEXT_START_COL);
-        std::cout << "\r" << CORRECT_COLOR << left << INITIAL_COLOR << right << RESET << "\n";
-        if (this->settings["show_stats"] == "1")
+        if (this->engine.is_streaming())
+            this->renderer.draw_viewport(this->engine.stream(), this->engine.score(), width);
+        else
+            this->renderer.draw_goal(this->engine.goal(), this->engine.goal_graphemes(), this->engine.score(), width);
+        if (this->racing())
+            this->renderer.draw_marks(this->engine.goal(), this->engine.goal_graphemes(), this->engine.score(), this->race.positions(), RACER_COLOR);
+        else if (this->ghost.active())
+            this->renderer.draw_marks(this->engine.goal(), this->engine.goal_graphemes(), this->engine.score(), this->ghost_marks, GHOST_COLOR);
+        if (this->settings.show_stats)
             this->display_stats();
+        if (this->settings.trailing_cursor && this->engine.is_streaming())
+            this->renderer.place_cursor(this->engine.stream(), this->engine.score());
+        else if (this->settings.trailing_cursor)
+            this->renderer.place_cursor(this->engine.goal_graphemes(), this->engine.score());
+        else
+            this->renderer.park_cursor(STATS_PARK_ROW);
+        this->renderer.present();
     }
 
     /// @brief display finished test stats
     void display_finish()
     {
-        terminal_jump_to(TEXT_START_ROW, TEXT_START_COL);
-        std::cout << "\r" << FINISHED_COLOR << this->results.goal << RESET << std::endl;
-        display_stats();
+        if (this->engine.is_streaming())
+            this->renderer.draw_viewport_finished(this->engine.stream(), get_terminal_size().width);
+        else
+            this->renderer.draw_finished(this->engine.goal(), get_terminal_size().width);
+        this->display_stats();
+        this->renderer.park_cursor(STATS_PARK_ROW);
+        this->renderer.present();
+    }
+
+    /// @brief read what the race server sent, a lost server ends the race (the app goes on with generated goals)
+    void receive_race()
+    {
+        if (this->race.receive())
+            return;
+        this->events.watch(-1);
+        this->logger << "=ERROR= Connection to the race server lost";
     }
 
+    /// @brief set the goal of the next race, if it hasn't started yet the server is told this racer is ready and the
+    /// other racers are waited for
+    /// @return false if the user went back or the server is gone
+    bool next_race()
+    {
+        if (!this->race.take_goal(this->prepared_goal))
+        {
+            this->race.request_next();
+            clear_terminal();
+            terminal_jump_to(0, 0);
+            std::cout << DESCRIPTION_COLOR << "Waiting for the other racers to be ready...\n"
+                      << "Press 'q' or 'ESC' to go back.\n"
+                      << RESET;
+            Screen::present();
+            while (!this->race.take_goal(this->prepared_goal))
+            {
+                const terminal_event event = this->events.next();
+                if (event.type == event_type::SOCKET)
+                    this->receive_race();
+                if (!this->racing() ||
+                    (event.type == event_type::KEY && (event.key.type == key_type::ESCAPE || lower_character(event.key) == GO_BACK_SHORTCUT)))
+                    return false;
+            }
+        }
+        this->engine.set_goal(this->prepared_goal);
+        this->logger << "race goal set";
+        return true;
+    }
+
+    /// @brief type the current goal until it's finished or the escape key is pressed
+    void run_test();
+
+    /// @brief show results of the finished test, save them and ask the user what to do next
+    /// @return AGAIN, NEXT or DONE
+    session_state finish_test();
+
     /// @brief quit app
     void quit()
     {
         clear_terminal();
         terminal_jump_to(0, 0);
+        Screen::present();
         this->logger << "app quit";
+        Logger::flush_all();
         exit(EXIT_SUCCESS);
     }
 
     /// @brief load defined default settings into the app
     void load_default_settings()
     {
-        this->settings = {
-            {"mode", "0"},
-            {"no_words", "10"},
-            {"words_filename", "words/words.txt"},
-            {"trailing_cursor", "1"},
-            {"show_stats", "1"}};
+        this->settings = typer_settings();
+        //? the words of the default list are loaded in case the text mode was set before (it doesn't use the Generator)
+        if (!this->streaming())
+            Generator::change_file(this->settings.words_filename);
         this->logger << "loaded default settings";
     }
 
-    /// @brief load settings from app's config file
+    /// @brief load settings from app's config file, invalid lines are logged and keep the default value
     void load_settings()
     {
-        std::ifstream infile(this->config_filename);
-        if (infile.is_open())
+        std::vector<std::string> errors;
+        if (this->settings.load(this->config_filename, errors))
         {
-            std::string line, name, value;
-            while (std::getline(infile, line))
-            {
-                std::size_t pos = line.find('=');
-                std::string name = line.substr(0, pos), value = line.substr(pos + 1);
-
-                settings[name] = value;
-            }
-            infile.close();
+            for (const std::string &error : errors)
+                this->logger << "=ERROR= " + error;
             this->logger << "loaded settings from config file " + this->config_filename;
         }
         else
@@ -253,8 +417,12 @@ private:
         if (default_settings)
             this->load_default_settings();
         std::ofstream outfile(this->config_filename);
-        for (auto const &[name, value] : settings)
-            outfile << name << "=" << value << std::endl;
+        for (const std::string &name : typer_settings::names())
+        {
+            std::string value = this->settings.get(name);
+            if (!value.empty())
+                outfile << name << "=" << value << std::endl;
+        }
         outfile.close();
         this->settings_changed = false;
         this->logger << "settings saved to " + this->config_filename;
@@ -279,7 +447,7 @@ private:
         const int16_t row_begin = std::count(description.begin(), description.end(), '\n') + 2, col_begin = 5, col_separate = 10;
         uint16_t current_col = col_begin;
         int16_t move = 0;
-        char key;
+        key_event key;
 
         auto is_hovered = [&current_col](uint32_t option_number)
         { return (col_begin + option_number * col_separate) == current_col; };
@@ -302,17 +470,22 @@ private:
                 }
             }
             terminal_jump_to(row_begin, current_col);
-            std::cout.flush();
-            key = get_input();
+            Screen::present();
+            key = get_key();
             move = handle_left_right_arrow_key(key) * col_separate;
-            if (key == ENTER)
+            if (key.type == key_type::ENTER)
             {
-                this->settings[setting_name] = option_name_value[((current_col - col_begin) / col_separate)].value;
+                std::string error;
+                if (!this->settings.set(setting_name, option_name_value[((current_col - col_begin) / col_separate)].value, error))
+                {
+                    this->logger << "=ERROR= " + error;
+                    return;
+                }
                 this->settings_changed = true;
                 this->logger << setting_name + " changed to: < " + option_name_value[((current_col - col_begin) / col_separate)].name + " >";
                 return;
             }
-            else if (key == GO_BACK_SHORTCUT)
+            else if (key.is(GO_BACK_SHORTCUT) || key.type == key_type::NONE)
                 return;
             else
                 switch_menu_item(move, current_col, col_begin, col_begin + (option_name_value.size() - 1) * col_separate);
@@ -321,17 +494,18 @@ private:
 
     bool is_from_config(const std::string &option_value, const std::string &setting_name)
     {
-        return option_value == this->settings[setting_name];
+        return option_value == this->settings.get(setting_name);
     }
 
-    /// @brief get all files from given path
+    /// @brief get all files from given path (precompiled .ttw lists are skipped, they are picked up through their text list)
     /// @param path path to directory with files
     /// @return vector with file names without path
     std::vector<std::string> get_filenames_vector(std::string path)
     {
         std::vector<std::string> files;
         for (const auto &entry : std::filesystem::directory_iterator(path))
-            files.push_back(entry.path().filename());
+            if (entry.path().extension() != TTW_EXTENSION)
+                files.push_back(entry.path().filename());
         return files;
     }
 
@@ -342,7 +516,8 @@ private:
     {
         try
         {
-            return (*std::filesystem::directory_iterator(path)).path().filename();
+            auto files = this->get_filenames_vector(path);
+            return files.empty() ? std::string("") : files.front();
         }
         catch (const std::exception &e)
         {
@@ -361,16 +536,26 @@ public:
     /// @brief main app menu
     void select_menu();
 
-    /// @brief begin typing test with defined goal
+    /// @brief typing session with the current goal, runs tests until the user goes back to the menu
     void start_test();
 
-    /// @brief change the test goal or reset the goal to be the same as the previous one
-    /// @param goal test text (defaults to ""), when "" resets the goal
-    void reset(std::string &&goal = "");
+    /// @brief reset test progress keeping the current goal (text mode starts from the beginning of the text)
+    void reset();
+
+    /// @brief reset test progress and generate a new goal in place of the current one (text mode opens the text again,
+    /// in a race the goal of the next race is taken)
+    /// @return false if there is no goal to type (the user left the race lobby, the text can't be opened or no words are loaded)
+    bool renew_goal();
 
     /// @brief settings menu
     void change_settings();
 
+    /// @brief statistics dashboard (rolling averages, accuracy trend, personal bests)
+    void display_history();
+
+    /// @brief menu for time limit option (timed mode)
+    void change_time_limit();
+
     /// @brief menu for words amount option
     void change_words_amount();
 
@@ -378,6 +563,11 @@ public:
     /// @param path path to directory with files
     void change_words_filename(const std::string &path = "words");
 
+    /// @brief connect to a race server, the tests are then raced on the goals it shares (classic mode)
+    /// @param socket_path path of the server socket
+    /// @return false if the server can't be reached
+    bool join_race(const std::string &socket_path);
+
     /// @brief run main app menu
     void run();
 };
\ No newline at end of file
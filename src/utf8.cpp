@@ -0,0 +1,211 @@
+#include "utf8.h"
+
+#include <algorithm>
+
+struct codepoint_range
+{
+    char32_t first;
+    char32_t last;
+};
+
+// marks drawn over the previous character, they take no column and belong to its grapheme
+static const codepoint_range COMBINING[] = {
+    {0x0300, 0x036F}, {0x0483, 0x0489}, {0x0591, 0x05BD}, {0x05BF, 0x05BF}, {0x05C1, 0x05C2}, {0x05C4, 0x05C5},
+    {0x05C7, 0x05C7}, {0x0610, 0x061A}, {0x064B, 0x065F}, {0x0670, 0x0670}, {0x06D6, 0x06DC}, {0x06DF, 0x06E4},
+    {0x0900, 0x0903}, {0x093A, 0x094F}, {0x0E31, 0x0E31}, {0x0E34, 0x0E3A}, {0x0E47, 0x0E4E}, {0x1AB0, 0x1AFF},
+    {0x1DC0, 0x1DFF}, {0x200D, 0x200D}, {0x20D0, 0x20FF}, {0xFE00, 0xFE0F}, {0xFE20, 0xFE2F}, {0x1F3FB, 0x1F3FF},
+    {0xE0020, 0xE007F}, {0xE0100, 0xE01EF}};
+
+// characters taking two columns (East Asian wide and fullwidth, emoji presentation)
+static const codepoint_range WIDE[] = {
+    {0x1100, 0x115F}, {0x231A, 0x231B}, {0x2329, 0x232A}, {0x23E9, 0x23EC}, {0x23F0, 0x23F0}, {0x23F3, 0x23F3},
+    {0x25FD, 0x25FE}, {0x2614, 0x2615}, {0x2648, 0x2653}, {0x267F, 0x267F}, {0x2693, 0x2693}, {0x26A1, 0x26A1},
+    {0x26AA, 0x26AB}, {0x26BD, 0x26BE}, {0x26C4, 0x26C5}, {0x26CE, 0x26CE}, {0x26D4, 0x26D4}, {0x26EA, 0x26EA},
+    {0x26F2, 0x26F3}, {0x26F5, 0x26F5}, {0x26FA, 0x26FA}, {0x26FD, 0x26FD}, {0x2705, 0x2705}, {0x270A, 0x270B},
+    {0x2728, 0x2728}, {0x274C, 0x274C}, {0x274E, 0x274E}, {0x2753, 0x2755}, {0x2757, 0x2757}, {0x2795, 0x2797},
+    {0x27B0, 0x27B0}, {0x27BF, 0x27BF}, {0x2B1B, 0x2B1C}, {0x2B50, 0x2B50}, {0x2B55, 0x2B55}, {0x2E80, 0x303E},
+    {0x3041, 0x33FF}, {0x3400, 0x4DBF}, {0x4E00, 0x9FFF}, {0xA000, 0xA4CF}, {0xA960, 0xA97F}, {0xAC00, 0xD7A3},
+    {0xF900, 0xFAFF}, {0xFE10, 0xFE19}, {0xFE30, 0xFE6F}, {0xFF00, 0xFF60}, {0xFFE0, 0xFFE6}, {0x1F004, 0x1F004},
+    {0x1F0CF, 0x1F0CF}, {0x1F18E, 0x1F18E}, {0x1F191, 0x1F19A}, {0x1F200, 0x1F2FF}, {0x1F300, 0x1F3FA},
+    {0x1F400, 0x1F64F}, {0x1F680, 0x1F6FF}, {0x1F900, 0x1F9FF}, {0x1FA70, 0x1FAFF}, {0x20000, 0x2FFFD},
+    {0x30000, 0x3FFFD}};
+
+/// @return true if the codepoint is in one of the sorted ranges
+template <std::size_t N>
+static bool in_ranges(const codepoint_range (&ranges)[N], char32_t codepoint)
+{
+    const codepoint_range *range = std::upper_bound(ranges, ranges + N, codepoint, [](char32_t c, const codepoint_range &r)
+                                                    { return c < r.first; });
+    return range != ranges && codepoint <= (range - 1)->last;
+}
+
+/// @return true for the letters pairing into flags
+static bool is_regional_indicator(char32_t codepoint)
+{
+    return codepoint >= 0x1F1E6 && codepoint <= 0x1F1FF;
+}
+
+std::size_t decode_utf8(const char *it, const char *end, char32_t &codepoint)
+{
+    const unsigned char lead = *it;
+    std::size_t length;
+    char32_t minimum;
+    if (lead < 0x80)
+    {
+        codepoint = lead;
+        return 1;
+    }
+    else if ((lead & 0xE0) == 0xC0)
+    {
+        length = 2;
+        minimum = 0x80;
+        codepoint = lead & 0x1F;
+    }
+    else if ((lead & 0xF0) == 0xE0)
+    {
+        length = 3;
+        minimum = 0x800;
+        codepoint = lead & 0x0F;
+    }
+    else if ((lead & 0xF8) == 0xF0)
+    {
+        length = 4;
+        minimum = 0x10000;
+        codepoint = lead & 0x07;
+    }
+    else
+    {
+        codepoint = REPLACEMENT_CHARACTER;
+        return 1;
+    }
+
+    for (std::size_t i = 1; i < length; ++i)
+    {
+        if (it + i == end)
+            return 0;
+        const unsigned char continuation = it[i];
+        if ((continuation & 0xC0) != 0x80)
+        {
+            codepoint = REPLACEMENT_CHARACTER;
+            return 1;
+        }
+        codepoint = codepoint << 6 | (continuation & 0x3F);
+    }
+    if (codepoint < minimum || codepoint > 0x10FFFF || (codepoint >= 0xD800 && codepoint <= 0xDFFF))
+    {
+        codepoint = REPLACEMENT_CHARACTER;
+        return 1;
+    }
+    return length;
+}
+
+void append_utf8(std::string &output, char32_t codepoint)
+{
+    if (codepoint < 0x80)
+        output += static_cast<char>(codepoint);
+    else if (codepoint < 0x800)
+    {
+        output += static_cast<char>(0xC0 | codepoint >> 6);
+        output += static_cast<char>(0x80 | (codepoint & 0x3F));
+    }
+    else if (codepoint < 0x10000)
+    {
+        output += static_cast<char>(0xE0 | codepoint >> 12);
+        output += static_cast<char>(0x80 | (codepoint >> 6 & 0x3F));
+        output += static_cast<char>(0x80 | (codepoint & 0x3F));
+    }
+    else
+    {
+        output += static_cast<char>(0xF0 | codepoint >> 18);
+        output += static_cast<char>(0x80 | (codepoint >> 12 & 0x3F));
+        output += static_cast<char>(0x80 | (codepoint >> 6 & 0x3F));
+        output += static_cast<char>(0x80 | (codepoint & 0x3F));
+    }
+}
+
+int codepoint_width(char32_t codepoint)
+{
+    if (codepoint < 0x20 || (codepoint >= 0x7F && codepoint < 0xA0))
+        return 0;
+    if (codepoint < 0x300)
+        return 1;
+    if (in_ranges(COMBINING, codepoint) || (codepoint >= 0x200B && codepoint <= 0x200F) || codepoint == 0xFEFF)
+        return 0;
+    return in_ranges(WIDE, codepoint) ? 2 : 1;
+}
+
+bool extends_grapheme(char32_t previous, char32_t codepoint)
+{
+    return previous == 0x200D || (codepoint >= 0x300 && in_ranges(COMBINING, codepoint));
+}
+
+void GraphemeIndex::clear()
+{
+    this->offsets.assign(1, 0);
+    this->columns.assign(1, 0);
+}
+
+void GraphemeIndex::build(std::string_view text)
+{
+    this->clear();
+    this->append(text, true);
+}
+
+void GraphemeIndex::append(std::string_view text, bool complete)
+{
+    const char *const begin = text.data(), *const end = begin + text.size();
+    const char *it = begin + this->offsets.back();
+    uint32_t column = this->columns.back();
+    while (it < end)
+    {
+        char32_t codepoint, next;
+        std::size_t length = decode_utf8(it, end, codepoint);
+        if (length == 0)
+        {
+            if (!complete)
+                return;
+            length = 1;
+            codepoint = REPLACEMENT_CHARACTER;
+        }
+        const char *cluster_end = it + length;
+        int width = codepoint_width(codepoint);
+        bool paired = false, cut = false;
+        char32_t previous = codepoint;
+        while (cluster_end < end)
+        {
+            const std::size_t next_length = decode_utf8(cluster_end, end, next);
+            if (next_length == 0)
+            {
+                cut = true;
+                break;
+            }
+            if (!extends_grapheme(previous, next))
+            {
+                //? two regional indicators make a flag
+                if (paired || !is_regional_indicator(codepoint) || !is_regional_indicator(next) || cluster_end != it + length)
+                    break;
+                paired = true;
+                width = 2;
+            }
+            cluster_end += next_length;
+            previous = next;
+        }
+        if (!complete && (cut || cluster_end >= end))
+            return;
+        column += width;
+        it = cluster_end;
+        this->offsets.push_back(it - begin);
+        this->columns.push_back(column);
+    }
+}
+
+void GraphemeIndex::erase_front(std::size_t count)
+{
+    const uint32_t offset = this->offsets[count], column = this->columns[count];
+    this->offsets.erase(this->offsets.begin(), this->offsets.begin() + count);
+    this->columns.erase(this->columns.begin(), this->columns.begin() + count);
+    for (uint32_t &o : this->offsets)
+        o -= offset;
+    for (uint32_t &c : this->columns)
+        c -= column;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#define REPLACEMENT_CHARACTER 0xFFFD
+
+/// @brief decode one UTF-8 sequence, invalid bytes are decoded one by one as REPLACEMENT_CHARACTER
+/// @param it first byte of the sequence
+/// @param end end of the text
+/// @param codepoint decoded codepoint
+/// @return number of bytes of the sequence, 0 if the sequence is cut by the end of the text
+std::size_t decode_utf8(const char *it, const char *end, char32_t &codepoint);
+
+/// @brief append UTF-8 encoding of given codepoint
+/// @param output string the encoding is appended to
+/// @param codepoint Unicode codepoint
+void append_utf8(std::string &output, char32_t codepoint);
+
+/// @param codepoint Unicode codepoint
+/// @return number of terminal columns the codepoint takes: 0 for combining marks, 2 for wide (East Asian, emoji), else 1
+int codepoint_width(char32_t codepoint);
+
+/// @param previous previous codepoint of the cluster
+/// @param codepoint following codepoint
+/// @return true if the codepoint belongs to the grapheme cluster of the previous one (combining marks, joiners, modifiers)
+bool extends_grapheme(char32_t previous, char32_t codepoint);
+
+/// @brief start of every grapheme cluster of a UTF-8 text (byte offset and display column), so a grapheme and its
+/// screen position are found in O(1) instead of scanning the text
+class GraphemeIndex
+{
+private:
+    std::vector<uint32_t> offsets = {0}; // byte offset of every grapheme followed by the end of the indexed text
+    std::vector<uint32_t> columns = {0}; // display column of every grapheme followed by the total width
+
+public:
+    /// @brief forget indexed graphemes (keeps the buffers)
+    void clear();
+
+    /// @brief index whole text
+    /// @param text UTF-8 text
+    void build(std::string_view text);
+
+    /// @brief index graphemes of the text following the already indexed part
+    /// @param text UTF-8 text, its beginning is the already indexed text
+    /// @param complete if false the last grapheme is not indexed, as it may continue in text appended later
+    void append(std::string_view text, bool complete);
+
+    /// @brief drop first graphemes, offsets and columns of the rest start from 0
+    /// @param count number of dropped graphemes
+    void erase_front(std::size_t count);
+
+    /// @return number of indexed graphemes
+    std::size_t size() const { return this->offsets.size() - 1; }
+
+    /// @param i grapheme number (size() for the end of the indexed text)
+    /// @return byte offset of the grapheme
+    uint32_t offset(std::size_t i) const { return this->offsets[i]; }
+
+    /// @param i grapheme number (size() for the end of the indexed text)
+    /// @return display column of the grapheme counted from the beginning of the text
+    uint32_t column(std::size_t i) const { return this->columns[i]; }
+
+    /// @param text indexed text
+    /// @param i grapheme number
+    /// @return bytes of the grapheme
+    std::string_view grapheme(std::string_view text, std::size_t i) const { return text.substr(this->offsets[i], this->offsets[i + 1] - this->offsets[i]); }
+};
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+/// @brief append LEB128 encoded unsigned value (7 bits per byte, high bit set on all but the last byte)
+/// @param out buffer the bytes are appended to
+/// @param value value to be encoded
+inline void append_varint(std::string &out, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        out += static_cast<char>((value & 0x7f) | 0x80);
+        value >>= 7;
+    }
+    out += static_cast<char>(value);
+}
+
+/// @brief decode LEB128 encoded unsigned value
+/// @param data first byte to be read, moved past the value on success
+/// @param end end of the buffer
+/// @param value decoded value
+/// @return false if the buffer ends in the middle of the value or the value is longer than 64 bits
+inline bool read_varint(const char *&data, const char *end, uint64_t &value)
+{
+    value = 0;
+    for (unsigned shift = 0; data < end && shift < 64; shift += 7)
+    {
+        unsigned char byte = static_cast<unsigned char>(*data++);
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            return true;
+    }
+    return false;
+}
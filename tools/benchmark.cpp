@@ -0,0 +1,540 @@
+#include "../src/generator.h"
+#include "../src/input.h"
+#include "../src/keystrokes.h"
+#include "../src/race.h"
+#include "../src/renderer.h"
+#include "../src/results_store.h"
+#include "../src/test_engine.h"
+#include "../src/timeline.h"
+#include "../src/typer.h"
+#include "../src/utf8.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <limits>
+#include <random>
+#include <thread>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#define BENCHMARK_OUTPUT "benchmark.json"
+#define BENCHMARK_WORDS_PATH "words"
+#define BENCHMARK_LOAD_RUNS 20
+#define BENCHMARK_GENERATE_CALLS 20000
+#define BENCHMARK_FRAMES 200000
+#define BENCHMARK_REPLAY_KEYS 2000000
+#define BENCHMARK_RACERS 200
+#define BENCHMARK_RACE_UPDATES 2000
+#define BENCHMARK_TIMELINES 20000
+#define BENCHMARK_RESULTS 200000
+#define BENCHMARK_QUERIES 50
+
+/// @brief minimal JSON writer, values are appended in document order
+class JsonWriter
+{
+private:
+    std::ostringstream out;
+    bool first = true;
+
+    void separate()
+    {
+        if (!this->first)
+            this->out << ",";
+        this->first = false;
+    }
+
+    void key(const std::string &name)
+    {
+        this->separate();
+        this->out << "\"" << name << "\":";
+    }
+
+public:
+    void begin_object(const std::string &name = "")
+    {
+        name.empty() ? this->separate() : this->key(name);
+        this->out << "{";
+        this->first = true;
+    }
+
+    void end_object()
+    {
+        this->out << "}";
+        this->first = false;
+    }
+
+    void begin_array(const std::string &name)
+    {
+        this->key(name);
+        this->out << "[";
+        this->first = true;
+    }
+
+    void end_array()
+    {
+        this->out << "]";
+        this->first = false;
+    }
+
+    void value(const std::string &name, const std::string &text)
+    {
+        this->key(name);
+        this->out << "\"";
+        for (char c : text)
+            if (c == '"' || c == '\\')
+                this->out << '\\' << c;
+            else
+                this->out << c;
+        this->out << "\"";
+    }
+
+    void value(const std::string &name, double number)
+    {
+        this->key(name);
+        this->out << std::setprecision(std::numeric_limits<double>::max_digits10) << number;
+    }
+
+    /// @brief counts and timestamps are written exactly, without going through a double
+    void value(const std::string &name, uint64_t number)
+    {
+        this->key(name);
+        this->out << number;
+    }
+
+    void value(const std::string &name, bool flag)
+    {
+        this->key(name);
+        this->out << (flag ? "true" : "false");
+    }
+
+    std::string str() const { return this->out.str(); }
+};
+
+/// @param function measured code
+/// @param iterations number of calls
+/// @return mean time of one call in nanoseconds
+template <typename function_t>
+double measure_ns(function_t function, uint64_t iterations)
+{
+    const auto begin = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < iterations; ++i)
+        function(i);
+    const auto took = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin);
+    return iterations == 0 ? 0. : (double)took.count() / iterations;
+}
+
+/// @brief write a word list of given size made of random letters
+/// @param filepath created file
+/// @param words number of words
+void write_synthetic_corpus(const std::string &filepath, uint32_t words)
+{
+    std::mt19937 engine(words);
+    std::uniform_int_distribution<int> length(2, 12), letter('a', 'z');
+    std::ofstream file(filepath);
+    std::string word;
+    for (uint32_t i = 0; i < words; ++i)
+    {
+        word.clear();
+        for (int j = length(engine); j > 0; --j)
+            word += static_cast<char>(letter(engine));
+        file << word << "\n";
+    }
+}
+
+/// @brief Generator::init/change_file load time of every word list in words/
+void benchmark_load(JsonWriter &json)
+{
+    std::vector<std::string> files;
+    for (const auto &entry : std::filesystem::directory_iterator(BENCHMARK_WORDS_PATH))
+        if (entry.path().extension() != TTW_EXTENSION)
+            files.push_back(entry.path().string());
+    std::sort(files.begin(), files.end());
+
+    json.begin_array("load");
+    bool initiated = false;
+    for (const std::string &file : files)
+    {
+        double init_us = -1.;
+        if (!initiated)
+        {
+            init_us = measure_ns([&](uint64_t)
+                                 { Generator::init(file); },
+                                 1) /
+                      1000.;
+            initiated = true;
+        }
+        const double change_file_us = measure_ns([&](uint64_t)
+                                                 { Generator::change_file(file); },
+                                                 BENCHMARK_LOAD_RUNS) /
+                                      1000.;
+        json.begin_object();
+        json.value("file", file);
+        json.value("words", (uint64_t)Generator::size());
+        json.value("precompiled", std::filesystem::exists(ttw_path_for(file)));
+        if (init_us >= 0.)
+            json.value("init_us", init_us);
+        json.value("change_file_us", change_file_us);
+        json.end_object();
+    }
+    json.end_array();
+}
+
+/// @brief generate(N) throughput for N = 5..50 on the word lists and on large synthetic corpora
+void benchmark_generate(JsonWriter &json)
+{
+    std::vector<std::string> corpora = {std::string(BENCHMARK_WORDS_PATH) + "/words.txt"};
+    std::vector<std::string> synthetic;
+    for (uint32_t words : {100000u, 1000000u})
+    {
+        synthetic.push_back((std::filesystem::temp_directory_path() / ("terminaltyper_benchmark_" + std::to_string(words) + ".txt")).string());
+        write_synthetic_corpus(synthetic.back(), words);
+        corpora.push_back(synthetic.back());
+    }
+
+    json.begin_array("generate");
+    std::string goal;
+    for (const std::string &corpus : corpora)
+    {
+        Generator::change_file(corpus);
+        Generator::seed(1);
+        for (uint32_t amount = 5; amount <= 50; amount += 5)
+        {
+            const double ns = measure_ns([&](uint64_t)
+                                         { Generator::generate(amount, goal); },
+                                         BENCHMARK_GENERATE_CALLS);
+            json.begin_object();
+            json.value("corpus", corpus);
+            json.value("corpus_words", (uint64_t)Generator::size());
+            json.value("amount", (uint64_t)amount);
+            json.value("ns_per_call", ns);
+            json.value("calls_per_s", 1e9 / ns);
+            json.end_object();
+        }
+    }
+    json.end_array();
+    for (const std::string &file : synthetic)
+        std::filesystem::remove(file);
+}
+
+/// @brief cost of building one test frame (goal progress and stats box, as in Typer::display_progress) and
+/// sending it to a null sink
+void benchmark_render(JsonWriter &json)
+{
+    Generator::change_file(std::string(BENCHMARK_WORDS_PATH) + "/words.txt");
+    Generator::seed(1);
+    const std::string goal = Generator::generate(50);
+    GraphemeIndex graphemes;
+    graphemes.build(goal);
+
+    //? frames are written to /dev/null, the write() is a part of the measured cost
+    const int null_fd = open("/dev/null", O_WRONLY), saved_stdout = dup(STDOUT_FILENO);
+    dup2(null_fd, STDOUT_FILENO);
+
+    ProgressRenderer renderer;
+    std::vector<std::string> lines(6);
+    std::string text;
+    uint64_t bytes = 0;
+    auto draw_stats = [&](uint64_t frame)
+    {
+        text.assign(30, '-');
+        centered_line(lines[0], text, 30, '+');
+        centered_line(lines[5], text, 30, '+');
+        text.assign("Accuracy: ").append(std::to_string(100 - frame % 7)).append("% ");
+        centered_line(lines[1], text);
+        text.assign("Elapsed = ").append(std::to_string(frame / 100.f)).append("s ");
+        centered_line(lines[2], text);
+        text.assign("WPM = ").append(std::to_string(60 + frame % 40)).append(" ");
+        centered_line(lines[3], text);
+        text.assign("Characters:  ").append(std::to_string(frame % graphemes.size())).append("/").append(std::to_string(graphemes.size())).append(" ");
+        centered_line(lines[4], text);
+        renderer.draw_stats(lines);
+    };
+    auto present = [&]()
+    {
+        bytes += Screen::frame().size();
+        renderer.present();
+    };
+
+    const double progress_ns = measure_ns([&](uint64_t frame)
+                                          {
+                                              const uint32_t score = frame % (graphemes.size() + 1);
+                                              if (score == 0)
+                                                  renderer.invalidate();
+                                              renderer.draw_goal(goal, graphemes, score, 80);
+                                              renderer.place_cursor(graphemes, score);
+                                              present(); },
+                                          BENCHMARK_FRAMES);
+    const double progress_bytes = (double)bytes / BENCHMARK_FRAMES;
+    bytes = 0;
+    const double stats_ns = measure_ns([&](uint64_t frame)
+                                       {
+                                           draw_stats(frame);
+                                           present(); },
+                                       BENCHMARK_FRAMES);
+    const double stats_bytes = (double)bytes / BENCHMARK_FRAMES;
+    bytes = 0;
+    const double full_ns = measure_ns([&](uint64_t frame)
+                                      {
+                                          renderer.invalidate();
+                                          renderer.draw_goal(goal, graphemes, frame % (graphemes.size() + 1), 80);
+                                          draw_stats(frame);
+                                          present(); },
+                                      BENCHMARK_FRAMES / 10);
+    const double full_bytes = (double)bytes / (BENCHMARK_FRAMES / 10);
+
+    dup2(saved_stdout, STDOUT_FILENO);
+    close(saved_stdout);
+    close(null_fd);
+
+    json.begin_object("render");
+    json.value("goal_graphemes", (uint64_t)graphemes.size());
+    json.value("progress_frame_ns", progress_ns);
+    json.value("progress_frame_bytes", progress_bytes);
+    json.value("stats_frame_ns", stats_ns);
+    json.value("stats_frame_bytes", stats_bytes);
+    json.value("full_redraw_ns", full_ns);
+    json.value("full_redraw_bytes", full_bytes);
+    json.end_object();
+}
+
+/// @brief simulated keystrokes through the input path of the test loop: key decoding and scoring by TestEngine
+/// (terminal I/O and rendering excluded)
+void benchmark_replay(JsonWriter &json)
+{
+    Generator::seed(1);
+    const std::string goal = Generator::generate(50);
+    TestEngine engine;
+    engine.set_goal(goal);
+
+    KeyDecoder decoder;
+    key_event key;
+    uint64_t position = 0, timestamp_ns = 0, completed = 0;
+    const double ns = measure_ns([&](uint64_t i)
+                                 {
+                                     //? every 16th key is a mistake
+                                     decoder.feed(i % 16 == 15 ? '#' : goal[position]);
+                                     if (!decoder.next(key))
+                                         return;
+                                     timestamp_ns += 100000000;
+                                     if (engine.type(timestamp_ns, key.codepoint) != key_outcome::WRONG)
+                                         ++position;
+                                     if (engine.finished())
+                                     {
+                                         engine.reset();
+                                         position = 0;
+                                         ++completed;
+                                     } },
+                                 BENCHMARK_REPLAY_KEYS);
+
+    json.begin_object("replay");
+    json.value("keys", (uint64_t)BENCHMARK_REPLAY_KEYS);
+    json.value("tests_completed", (uint64_t)completed);
+    json.value("ns_per_key", ns);
+    json.value("keys_per_s", 1e9 / ns);
+    json.end_object();
+}
+
+/// @brief wait until the client received what satisfies the condition
+/// @return false if nothing came for a second or the server is gone
+template <typename condition_t>
+bool await_race(RaceClient &client, condition_t condition)
+{
+    while (!condition())
+    {
+        struct pollfd readable = {client.socket(), POLLIN, 0};
+        if (poll(&readable, 1, 1000) <= 0 || !client.receive())
+            return false;
+    }
+    return true;
+}
+
+void benchmark_race(JsonWriter &json)
+{
+    const std::string socket_path = (std::filesystem::temp_directory_path() / "terminaltyper_benchmark.sock").string();
+    RaceServer server(socket_path);
+    std::string error, goal;
+    if (!server.listen(error))
+    {
+        std::cerr << error << std::endl;
+        return;
+    }
+    std::thread serving(&RaceServer::serve, &server);
+
+    std::vector<RaceClient> racers(BENCHMARK_RACERS);
+    bool connected = true;
+    for (RaceClient &racer : racers)
+        connected = connected && racer.connect(socket_path, error) && await_race(racer, [&]
+                                                                                  { return racer.take_goal(goal); });
+
+    //? every update is sent by one racer, the fan-out time is measured until the sockets of all the others are
+    //? readable, parsing the update on the client side is checked afterwards and not timed
+    std::vector<double> fan_out_ns;
+    std::vector<struct pollfd> sockets;
+    for (uint32_t update = 1; connected && update <= BENCHMARK_RACE_UPDATES; ++update)
+    {
+        RaceClient &sender = racers[update % racers.size()];
+        sockets.clear();
+        for (RaceClient &racer : racers)
+            if (&racer != &sender)
+                sockets.push_back({racer.socket(), POLLIN, 0});
+
+        const auto begin = std::chrono::steady_clock::now();
+        sender.send_progress(update);
+        for (std::size_t waiting = sockets.size(); connected && waiting > 0;)
+        {
+            connected = poll(sockets.data(), sockets.size(), 1000) > 0;
+            for (struct pollfd &socket : sockets)
+                if (socket.revents != 0)
+                {
+                    socket.fd = -1;
+                    socket.revents = 0;
+                    --waiting;
+                }
+        }
+        fan_out_ns.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count());
+
+        for (RaceClient &racer : racers)
+            if (&racer != &sender)
+                connected = connected && await_race(racer, [&]
+                                                    { const std::vector<uint32_t> &positions = racer.positions();
+                                                      return std::binary_search(positions.begin(), positions.end(), update); });
+        //? the sender reads its own echo, so its socket isn't readable before the next update is sent
+        struct pollfd echo = {sender.socket(), POLLIN, 0};
+        connected = connected && poll(&echo, 1, 1000) > 0 && sender.receive();
+    }
+    server.stop();
+    serving.join();
+    if (!connected || fan_out_ns.empty())
+    {
+        std::cerr << "race benchmark failed: " << error << std::endl;
+        return;
+    }
+
+    std::sort(fan_out_ns.begin(), fan_out_ns.end());
+    double sum = 0.;
+    for (double ns : fan_out_ns)
+        sum += ns;
+    json.begin_object("race");
+    json.value("racers", (uint64_t)BENCHMARK_RACERS);
+    json.value("updates", (uint64_t)fan_out_ns.size());
+    json.value("fan_out_mean_ns", sum / fan_out_ns.size());
+    json.value("fan_out_p99_ns", fan_out_ns[fan_out_ns.size() * 99 / 100]);
+    json.value("fan_out_max_ns", fan_out_ns.back());
+    json.end_object();
+}
+
+void benchmark_timeline(JsonWriter &json)
+{
+    //? a 50 word goal typed at 80 WPM with a natural spread of the key intervals
+    Generator::seed(1);
+    const std::string goal = Generator::generate(50);
+    TestEngine engine;
+    engine.set_goal(goal);
+    std::mt19937 random(1);
+    std::normal_distribution<double> interval_ms(150., 50.);
+    uint64_t timestamp_ns = 0;
+    while (!engine.finished())
+    {
+        timestamp_ns += std::max(20., interval_ms(random)) * 1000000;
+        engine.type(timestamp_ns, engine.expected());
+    }
+
+    std::string encoded;
+    timeline decoded;
+    const double encode_ns = measure_ns([&](uint64_t)
+                                        { encoded.clear();
+                                          TimelineStore::encode(engine.timeline(), encoded); },
+                                        BENCHMARK_TIMELINES);
+    const double decode_ns = measure_ns([&](uint64_t)
+                                        { TimelineStore::decode(encoded.data(), encoded.data() + encoded.size(), decoded); },
+                                        BENCHMARK_TIMELINES);
+
+    json.begin_object("timeline");
+    json.value("graphemes", (uint64_t)engine.timeline().size());
+    json.value("encoded_bytes", (uint64_t)encoded.size());
+    json.value("bytes_per_grapheme", (double)encoded.size() / engine.timeline().size());
+    json.value("encode_ns", encode_ns);
+    json.value("decode_ns", decode_ns);
+    json.value("round_trip", decoded == engine.timeline());
+    json.end_object();
+}
+
+/// @brief ResultsStore::query over a file of BENCHMARK_RESULTS stored results
+void benchmark_results(JsonWriter &json)
+{
+    const std::string path = (std::filesystem::temp_directory_path() / "terminaltyper_benchmark_results.db").string();
+    std::filesystem::remove(path);
+    const uint32_t corpus_ids[] = {ResultsStore::corpus_id("words.txt"), ResultsStore::corpus_id("polish.txt")};
+    std::mt19937 random(1);
+    std::normal_distribution<float> wpm(70.f, 15.f), accuracy(0.95f, 0.03f);
+    {
+        ResultsStore store(path);
+        for (uint32_t i = 0; i < BENCHMARK_RESULTS; ++i)
+        {
+            result_record record = {};
+            record.timestamp = 1700000000 + i * 60;
+            record.corpus_id = corpus_ids[i % 2];
+            record.word_count = 25;
+            record.accuracy = std::clamp(accuracy(random), 0.f, 1.f);
+            record.wpm = std::max(0.f, wpm(random));
+            record.time_s = record.word_count * 60.f / std::max(1.f, record.wpm);
+            if (!store.append(record))
+            {
+                std::cerr << "Unable to write " << path << std::endl;
+                return;
+            }
+        }
+    }
+
+    const ResultsStore store(path);
+    results_summary all, latest;
+    const double query_all_ns = measure_ns([&](uint64_t)
+                                           { all = store.query(0); },
+                                           BENCHMARK_QUERIES);
+    const double query_latest_ns = measure_ns([&](uint64_t)
+                                              { latest = store.query(1000, corpus_ids[0]); },
+                                              BENCHMARK_QUERIES);
+    std::filesystem::remove(path);
+
+    json.begin_object("results");
+    json.value("stored", (uint64_t)BENCHMARK_RESULTS);
+    json.value("query_all_ns", query_all_ns);
+    json.value("query_all_count", (uint64_t)all.count);
+    json.value("query_all_median_wpm", all.median_wpm);
+    json.value("query_last_1000_of_corpus_ns", query_latest_ns);
+    json.value("query_last_1000_of_corpus_count", (uint64_t)latest.count);
+    json.end_object();
+}
+
+/// @brief measure Generator, renderer, input path, race fan-out and result queries and write the results as JSON
+int main(int argc, char *argv[])
+{
+    const std::string output = argc > 1 ? argv[1] : BENCHMARK_OUTPUT;
+    JsonWriter json;
+    json.begin_object();
+    json.value("timestamp", (uint64_t)std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+    json.begin_object("generator");
+    benchmark_load(json);
+    benchmark_generate(json);
+    json.end_object();
+    benchmark_render(json);
+    benchmark_replay(json);
+    benchmark_race(json);
+    benchmark_timeline(json);
+    benchmark_results(json);
+    json.end_object();
+
+    std::ofstream file(output);
+    if (!file)
+    {
+        std::cerr << "Unable to write " << output << std::endl;
+        return 1;
+    }
+    file << json.str() << std::endl;
+    std::cout << "benchmark results written to " << output << std::endl;
+    Logger::flush_all();
+    return 0;
+}
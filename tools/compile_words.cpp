@@ -0,0 +1,27 @@
+#include "../src/ttw.h"
+
+#include <iostream>
+
+/// @brief compile every given text word list into .ttw next to it
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "usage: " << argv[0] << " WORDS_FILE..." << std::endl;
+        return 1;
+    }
+
+    int status = 0;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string error, ttw_path = ttw_path_for(argv[i]);
+        if (ttw_compile(argv[i], ttw_path, error))
+            std::cout << argv[i] << " -> " << ttw_path << std::endl;
+        else
+        {
+            std::cerr << "Error while compiling " << argv[i] << ": " << error << std::endl;
+            status = 1;
+        }
+    }
+    return status;
+}
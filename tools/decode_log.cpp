@@ -0,0 +1,54 @@
+#include "../src/logger.h"
+
+#include <iterator>
+
+/// @brief print binary log written by Logger with log_format::BINARY in the text log format
+int main(int argc, char *argv[])
+{
+    if (argc != 2)
+    {
+        std::cerr << "usage: " << argv[0] << " LOG_FILE" << LOG_BINARY_EXTENSION << std::endl;
+        return 1;
+    }
+
+    std::ifstream file(argv[1], std::ios::binary);
+    if (!file)
+    {
+        std::cerr << "Unable to open file " << argv[1] << std::endl;
+        return 1;
+    }
+    const std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    const char *data = content.data(), *end = data + content.size();
+    if (content.size() < 5 || content.compare(0, 4, LOG_BINARY_MAGIC) != 0 || data[4] != LOG_BINARY_VERSION)
+    {
+        std::cerr << argv[1] << " is not a binary log" << std::endl;
+        return 1;
+    }
+    data += 5;
+
+    TimestampCache timestamp;
+    std::string source;
+    uint64_t time_ms = 0, value = 0, length = 0;
+    while (data < end)
+    {
+        const char tag = *data++;
+        if (tag == LOG_RECORD_SESSION && read_varint(data, end, time_ms) && read_varint(data, end, length) && length <= static_cast<uint64_t>(end - data))
+        {
+            source.assign(data, length);
+            data += length;
+        }
+        else if (tag == LOG_RECORD_MESSAGE && read_varint(data, end, value) && read_varint(data, end, length) && length <= static_cast<uint64_t>(end - data))
+        {
+            time_ms += value;
+            auto time = std::chrono::system_clock::time_point(std::chrono::milliseconds(time_ms));
+            std::cout << "[" << timestamp.format(time) << "] " << source << ": " << std::string_view(data, length) << '\n';
+            data += length;
+        }
+        else
+        {
+            std::cerr << "Corrupted record at byte " << (data - content.data() - 1) << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}